@@ -33,18 +33,22 @@ public:
     ~TreeWidgetViewCollapseButton() override = default;
 
     void initUI() {
-        setStyleSheet(R"(
-            QPushButton {
-                background-color: #3c3f41;
-                color: white;
-                border: 2px solid #555;
-                border-radius: 4px;
-                padding: 2px;
-            }
-            QPushButton:hover {
-                background-color: #4c5052;
-            }
-        )");
+        // the dark theme paints the same look natively, the style sheet is only needed without it
+        setObjectName(utilWidgets::DarkStyle::HeavyButtonName);
+        if (!utilWidgets::isDarkThemeEnabled()) {
+            setStyleSheet(R"(
+                QPushButton {
+                    background-color: #3c3f41;
+                    color: white;
+                    border: 2px solid #555;
+                    border-radius: 4px;
+                    padding: 2px;
+                }
+                QPushButton:hover {
+                    background-color: #4c5052;
+                }
+            )");
+        }
 
         setText(m_expandedMark);
         setMinimumWidth(30);
@@ -561,13 +565,24 @@ public:
         // controls
         m_mainScroll = new QScrollArea(this);
         m_mainScroll->setWidgetResizable(true);
-        m_mainScroll->setStyleSheet(R"(
-            QScrollArea {
-                border: 2px solid #8e2dc5;
-                border-radius: 5px;
-                background-color: #1f1f1f;
-            }
-        )");
+        // under the dark theme the border is painted natively and the background comes from the palette,
+        // a style sheet would force QStyleSheetStyle onto every item
+        m_mainScroll->setObjectName(utilWidgets::DarkStyle::AccentFrameName);
+        if (utilWidgets::isDarkThemeEnabled()) {
+            QPalette scrollPalette = m_mainScroll->palette();
+            scrollPalette.setColor(QPalette::Window, QColor("#1f1f1f"));
+            m_mainScroll->setPalette(scrollPalette);
+            m_mainScroll->viewport()->setBackgroundRole(QPalette::Window);
+            m_mainScroll->viewport()->setAutoFillBackground(true);
+        } else {
+            m_mainScroll->setStyleSheet(R"(
+                QScrollArea {
+                    border: 2px solid #8e2dc5;
+                    border-radius: 5px;
+                    background-color: #1f1f1f;
+                }
+            )");
+        }
 
         m_rootItem = new InvisibleRootItem(this);
         m_mainScroll->setWidget(m_rootItem);
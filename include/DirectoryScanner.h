@@ -0,0 +1,357 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <QDir>
+#include <QSet>
+#include <QMutex>
+#include <QDateTime>
+#include <QThread>
+#include <QObject>
+#include <QFileInfo>
+#include <QPointer>
+#include <QThreadPool>
+#include <QDirIterator>
+#include <QWaitCondition>
+#include <QRegularExpression>
+#include <QCoreApplication>
+
+
+namespace general_util {
+
+    struct DirectoryScanOptions
+    {
+        QStringList nameFilters = {"*"};                    // wildcards matched against file names
+        QStringList excludeFiles;                           // wildcards, e.g. {"__init__.py"}
+        QStringList excludeDirs = {"__pycache__", ".git"};  // wildcards matched against directory names
+        bool recursive = true;
+        bool followSymlinks = false;
+        bool hidden = true;                                 // include hidden files and enter hidden directories
+        Qt::CaseSensitivity caseSensitivity =               // of the wildcards
+#ifdef _WIN32
+                                              Qt::CaseInsensitive;
+#else
+                                              Qt::CaseSensitive;
+#endif
+        int threads = 0;                                    // 0 - twice the core count, scanning waits on I/O
+    };
+
+
+    namespace detail {
+        inline QList<QRegularExpression> compileWildcards(const QStringList& wildcards, const Qt::CaseSensitivity cs) {
+            QList<QRegularExpression> result;
+            for (const QString& wildcard : wildcards) {
+                QRegularExpression regex = QRegularExpression::fromWildcard(wildcard, cs);
+                regex.optimize();
+                result.append(regex);
+            }
+            return result;
+        }
+
+        inline bool matchesAny(const QList<QRegularExpression>& regexes, const QString& name) {
+            for (const QRegularExpression& regex : regexes) {
+                if (regex.match(name).hasMatch()) return true;
+            }
+            return false;
+        }
+    }
+
+
+    // one listed directory, see DirectoryScan::setListingCallback()
+    struct DirectoryListing
+    {
+        QString path;
+        QDateTime lastModified;     // of the directory, read before listing it
+        QStringList subdirs;        // all that are not excluded, entered or not
+        QFileInfoList files;        // the matching files
+    };
+
+
+    /* Walks directory trees on a thread pool, one task per directory, and hands the matching
+    file paths to a callback in per-directory batches as they are found.
+    The callbacks run on the pool threads, they have to be thread-safe.
+
+    Incremental indexers can also get every listing with its subdirectories and file
+    stat data, and decide per subdirectory whether it is entered.
+
+    Example usage:
+        DirectoryScanOptions options;
+        options.nameFilters = {"*.py"};
+        DirectoryScan scan(options);
+        scan.start({root}, [](const QStringList& batch) { ... });
+        scan.wait();
+    */
+    class DirectoryScan
+    {
+    public:
+        using BatchCallback = std::function<void(const QStringList& files)>;
+        using FinishedCallback = std::function<void(bool cancelled)>;
+        using ListingCallback = std::function<void(const DirectoryListing& listing)>;
+        using DescendFilter = std::function<bool(const QString& dir)>;
+
+    private:
+        struct State {
+            QThreadPool* pool = nullptr;
+            DirectoryScanOptions options;
+            QList<QRegularExpression> nameFilters;
+            QList<QRegularExpression> excludeFiles;
+            QList<QRegularExpression> excludeDirs;
+            BatchCallback onBatch;
+            FinishedCallback onFinished;
+            ListingCallback onListing;
+            DescendFilter descendFilter;
+
+            std::atomic<int> pending {0};
+            std::atomic<bool> cancelled {false};
+            QMutex mutex;
+            QWaitCondition done;
+            bool finished = false;
+            QSet<QString> visited;      // canonical paths, only tracked with followSymlinks
+
+            // false when the directory was entered before, symlinks can form cycles
+            bool enter(const QFileInfo& dir) {
+                if (!options.followSymlinks) return true;
+                const QString canonical = dir.canonicalFilePath();
+                if (canonical.isEmpty()) return false;
+                QMutexLocker locker(&mutex);
+                if (visited.contains(canonical)) return false;
+                visited.insert(canonical);
+                return true;
+            }
+        };
+
+        std::unique_ptr<QThreadPool> m_pool;
+        std::shared_ptr<State> m_state;
+
+    public:
+        explicit DirectoryScan(const DirectoryScanOptions& options = DirectoryScanOptions()) {
+            m_pool = std::make_unique<QThreadPool>();
+            m_pool->setMaxThreadCount(options.threads > 0 ? options.threads : qMax(4, QThread::idealThreadCount() * 2));
+
+            m_state = std::make_shared<State>();
+            m_state->pool = m_pool.get();
+            m_state->options = options;
+            m_state->nameFilters = detail::compileWildcards(options.nameFilters, options.caseSensitivity);
+            m_state->excludeFiles = detail::compileWildcards(options.excludeFiles, options.caseSensitivity);
+            m_state->excludeDirs = detail::compileWildcards(options.excludeDirs, options.caseSensitivity);
+        }
+
+        ~DirectoryScan() {
+            cancel();
+            m_pool->waitForDone();
+        }
+
+        DirectoryScan(const DirectoryScan&) = delete;
+        DirectoryScan& operator=(const DirectoryScan&) = delete;
+
+        // set before start()
+        void setListingCallback(ListingCallback callback) { m_state->onListing = std::move(callback); }
+
+        // subdirectories it rejects still show up in DirectoryListing::subdirs, set before start()
+        void setDescendFilter(DescendFilter filter) { m_state->descendFilter = std::move(filter); }
+
+        /* Start scanning 'roots', once per DirectoryScan. 'onBatch' may be empty.
+        */
+        void start(const QStringList& roots, BatchCallback onBatch, FinishedCallback onFinished = nullptr) {
+            m_state->onBatch = std::move(onBatch);
+            m_state->onFinished = std::move(onFinished);
+
+            QStringList dirs;
+            for (const QString& root : roots) {
+                const QFileInfo info(root);
+                if (info.isDir() && m_state->enter(info)) dirs.append(root);
+            }
+            if (dirs.isEmpty()) {
+                finish(*m_state);
+                return;
+            }
+            m_state->pending.store(int(dirs.count()));
+            for (const QString& dir : dirs)
+                submit(m_state, dir);
+        }
+
+        void cancel() { m_state->cancelled.store(true); }
+        bool isCancelled() const { return m_state->cancelled.load(); }
+
+        bool isFinished() const {
+            QMutexLocker locker(&m_state->mutex);
+            return m_state->finished;
+        }
+
+        // returns false on timeout
+        bool wait(const int msecs = -1) {
+            QMutexLocker locker(&m_state->mutex);
+            if (m_state->finished) return true;
+            return m_state->done.wait(&m_state->mutex, msecs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(msecs));
+        }
+
+    private:
+        static void submit(const std::shared_ptr<State>& state, const QString& dir) {
+            state->pool->start([state, dir]() { scanDirectory(state, dir); });
+        }
+
+        static void scanDirectory(const std::shared_ptr<State>& state, const QString& dir) {
+            State& s = *state;
+            QStringList files;
+            DirectoryListing listing;
+
+            if (!s.cancelled.load(std::memory_order_relaxed)) {
+                if (s.onListing) {
+                    listing.path = dir;
+                    listing.lastModified = QFileInfo(dir).lastModified();
+                }
+
+                // one level only, subdirectories become tasks of their own
+                QDir::Filters filters = QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::System;
+                if (s.options.hidden) filters |= QDir::Hidden;
+                QDirIterator it(dir, filters);
+                while (it.hasNext()) {
+                    if (s.cancelled.load(std::memory_order_relaxed)) break;
+                    it.next();
+                    const QFileInfo info = it.fileInfo();
+                    const QString name = it.fileName();
+
+                    if (info.isDir()) {
+                        if (!s.options.recursive || detail::matchesAny(s.excludeDirs, name)) continue;
+                        if (info.isSymLink() && !s.options.followSymlinks) continue;
+                        const QString path = it.filePath();
+                        if (s.onListing) listing.subdirs.append(path);
+                        if (s.descendFilter && !s.descendFilter(path)) continue;
+                        if (!s.enter(info)) continue;
+                        s.pending.fetch_add(1);
+                        submit(state, path);
+                    } else if (detail::matchesAny(s.nameFilters, name) && !detail::matchesAny(s.excludeFiles, name)) {
+                        files.append(it.filePath());
+                        if (s.onListing) listing.files.append(info);
+                    }
+                }
+            }
+
+            if (s.onListing && !s.cancelled.load()) s.onListing(listing);
+            if (!files.isEmpty() && s.onBatch && !s.cancelled.load()) s.onBatch(files);
+            if (s.pending.fetch_sub(1) == 1) finish(s);
+        }
+
+        static void finish(State& s) {
+            if (s.onFinished) s.onFinished(s.cancelled.load());
+            QMutexLocker locker(&s.mutex);
+            s.finished = true;
+            s.done.wakeAll();
+        }
+    };
+
+
+    /* Blocking scan, sorted result.
+    */
+    inline QStringList findFiles(const QStringList& roots, const DirectoryScanOptions& options = DirectoryScanOptions()) {
+        QStringList result;
+        QMutex mutex;
+        DirectoryScan scan(options);
+        scan.start(roots, [&result, &mutex](const QStringList& files) {
+            QMutexLocker locker(&mutex);
+            result.append(files);
+        });
+        scan.wait();
+        result.sort();
+        return result;
+    }
+
+}   // namespace general_util
+
+
+/* Asynchronous directory scan for the GUI thread.
+Batches found on the pool threads are coalesced and delivered through filesFound()
+on the scanner's thread; finished() follows the last batch.
+
+Example usage:
+    DirectoryScanner* scanner = new DirectoryScanner(this);
+    connect(scanner, &DirectoryScanner::filesFound, this, [](const QStringList& files) { ... });
+    connect(scanner, &DirectoryScanner::finished, this, [](bool cancelled) { ... });
+
+    general_util::DirectoryScanOptions options;
+    options.nameFilters = {"*.py", "*.mel"};
+    scanner->start({general_util::getPythonScriptPath()}, options);
+*/
+class DirectoryScanner : public QObject
+{
+Q_OBJECT
+
+signals:
+    void filesFound(const QStringList& files);
+    void finished(bool cancelled);
+
+private:
+    struct Buffer {
+        QMutex mutex;
+        QStringList files;
+        bool flushScheduled = false;
+    };
+
+    std::unique_ptr<general_util::DirectoryScan> m_scan;
+    std::shared_ptr<Buffer> m_buffer;
+    int m_generation = 0;
+    int m_count = 0;
+
+public:
+    explicit DirectoryScanner(QObject* parent = nullptr) : QObject(parent) {}
+
+    ~DirectoryScanner() override {
+        cancel();
+        m_scan.reset();
+    }
+
+    /* Start a new scan, a scan still running is cancelled first.
+    */
+    void start(const QStringList& roots, const general_util::DirectoryScanOptions& options = general_util::DirectoryScanOptions()) {
+        cancel();
+        m_scan.reset();     // waits for the old pool threads
+
+        const int generation = ++m_generation;
+        m_count = 0;
+        auto buffer = std::make_shared<Buffer>();
+        m_buffer = buffer;
+        QPointer<DirectoryScanner> self(this);
+
+        m_scan = std::make_unique<general_util::DirectoryScan>(options);
+        m_scan->start(roots, [self, buffer, generation](const QStringList& files) {
+            QMutexLocker locker(&buffer->mutex);
+            buffer->files.append(files);
+            if (buffer->flushScheduled) return;
+            buffer->flushScheduled = true;
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, generation]() {
+                if (self) self->flush(generation, false, false);
+            }, Qt::QueuedConnection);
+        }, [self, generation](bool cancelled) {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, generation, cancelled]() {
+                if (self) self->flush(generation, true, cancelled);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    void cancel() {
+        if (m_scan) m_scan->cancel();
+    }
+
+    bool isRunning() const { return m_scan && !m_scan->isFinished(); }
+
+    // files delivered by the current scan so far
+    int count() const { return m_count; }
+
+private:
+    void flush(const int generation, const bool done, const bool cancelled) {
+        if (generation != m_generation) return;
+
+        QStringList files;
+        {
+            QMutexLocker locker(&m_buffer->mutex);
+            files.swap(m_buffer->files);
+            m_buffer->flushScheduled = false;
+        }
+        if (!files.isEmpty()) {
+            m_count += files.count();
+            emit filesFound(files);
+        }
+        if (done) emit finished(cancelled);
+    }
+
+};
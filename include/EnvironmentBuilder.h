@@ -0,0 +1,283 @@
+#pragma once
+#include <QDir>
+#include <QSet>
+#include <QHash>
+#include <QMutex>
+#include <QLabel>
+#include <QVector>
+#include <QWidget>
+#include <QLineEdit>
+#include <QTableView>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QStandardItemModel>
+#include <QProcessEnvironment>
+#include <QSortFilterProxyModel>
+
+
+namespace general_util {
+
+    namespace detail {
+        inline QMutex& environmentMutex() {
+            static QMutex mutex;
+            return mutex;
+        }
+
+        inline QProcessEnvironment& environmentSnapshot() {
+            static QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+            return env;
+        }
+
+        // pythonEnvironment() results, dropped when the snapshot is refreshed
+        inline QHash<QString, QProcessEnvironment>& pythonEnvironmentCache() {
+            static QHash<QString, QProcessEnvironment> cache;
+            return cache;
+        }
+    }
+
+    /* Snapshot of the system environment, taken once.
+    QProcessEnvironment is implicitly shared, so handing it to many processes costs nothing
+    until one of them is modified.
+    */
+    inline QProcessEnvironment baseEnvironment() {
+        QMutexLocker locker(&detail::environmentMutex());
+        return detail::environmentSnapshot();
+    }
+
+    // take a new snapshot, e.g. after qputenv()
+    inline void refreshBaseEnvironment() {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        QMutexLocker locker(&detail::environmentMutex());
+        detail::environmentSnapshot() = env;
+        detail::pythonEnvironmentCache().clear();
+    }
+
+    /* Join path lists with the platform separator (';' on Windows, ':' elsewhere),
+    skipping empty and duplicate entries. The first occurrence of an entry wins.
+    */
+    inline QString joinPathList(const QStringList& paths) {
+        QStringList result;
+        QSet<QString> seen;
+        for (const QString& path : paths) {
+            if (path.isEmpty()) continue;
+#ifdef _WIN32
+            const QString key = QDir::cleanPath(path).toLower();
+#else
+            const QString key = QDir::cleanPath(path);
+#endif
+            if (seen.contains(key)) continue;
+            seen.insert(key);
+            result.append(path);
+        }
+        return result.join(QDir::listSeparator());
+    }
+
+    inline QStringList splitPathList(const QString& value) {
+        return value.split(QDir::listSeparator(), Qt::SkipEmptyParts);
+    }
+
+
+    /* Overlay on top of baseEnvironment() for child processes.
+    Only the changes are stored; build() applies them to the shared base once
+    and caches the result until the next change.
+
+    Example usage:
+        QProcessEnvironment env = general_util::EnvironmentBuilder()
+                                    .appendPath("PYTHONPATH", pyPaths)
+                                    .set("OMP_NUM_THREADS", "1")
+                                    .unset("PYTHONHOME")
+                                    .build();
+        process->setProcessEnvironment(env);
+    */
+    class EnvironmentBuilder
+    {
+    private:
+        struct Change {
+            enum Kind { Set, Unset, Prepend, Append } kind;
+            QString name;
+            QString value;
+            QStringList paths;
+        };
+
+        QProcessEnvironment m_base;
+        QVector<Change> m_changes;
+        mutable QProcessEnvironment m_built;
+        mutable bool m_dirty = true;
+
+    public:
+        EnvironmentBuilder() : m_base(baseEnvironment()) {}
+        explicit EnvironmentBuilder(const QProcessEnvironment& base) : m_base(base) {}
+
+        EnvironmentBuilder& set(const QString& name, const QString& value) {
+            return change({Change::Set, name, value, {}});
+        }
+
+        EnvironmentBuilder& unset(const QString& name) {
+            return change({Change::Unset, name, {}, {}});
+        }
+
+        // path-list variables (PATH, PYTHONPATH, ...): entries are deduplicated
+        EnvironmentBuilder& prependPath(const QString& name, const QStringList& paths) {
+            return change({Change::Prepend, name, {}, paths});
+        }
+
+        EnvironmentBuilder& appendPath(const QString& name, const QStringList& paths) {
+            return change({Change::Append, name, {}, paths});
+        }
+
+        bool isEmpty() const { return m_changes.isEmpty(); }
+
+        QProcessEnvironment build() const {
+            if (!m_dirty) return m_built;
+
+            QProcessEnvironment env = m_base;
+            for (const Change& c : m_changes) {
+                switch (c.kind) {
+                case Change::Set:
+                    env.insert(c.name, c.value);
+                    break;
+                case Change::Unset:
+                    env.remove(c.name);
+                    break;
+                case Change::Prepend:
+                    env.insert(c.name, joinPathList(c.paths + splitPathList(env.value(c.name))));
+                    break;
+                case Change::Append:
+                    env.insert(c.name, joinPathList(splitPathList(env.value(c.name)) + c.paths));
+                    break;
+                }
+            }
+            m_built = env;
+            m_dirty = false;
+            return m_built;
+        }
+
+    private:
+        EnvironmentBuilder& change(Change&& c) {
+            m_changes.append(std::move(c));
+            m_dirty = true;
+            return *this;
+        }
+    };
+
+    /* baseEnvironment() with 'pyPaths' appended to PYTHONPATH.
+    Results are cached per path list, so thousands of launches with the same paths
+    share one environment instead of copying the system environment each time.
+    */
+    inline QProcessEnvironment pythonEnvironment(const QStringList& pyPaths) {
+        if (pyPaths.isEmpty()) return baseEnvironment();
+
+        const QString key = pyPaths.join(QChar('\n'));
+        QMutexLocker locker(&detail::environmentMutex());
+        QHash<QString, QProcessEnvironment>& cache = detail::pythonEnvironmentCache();
+        auto it = cache.constFind(key);
+        if (it != cache.constEnd()) return it.value();
+
+        if (cache.size() >= 64) cache.clear();
+        QProcessEnvironment env = EnvironmentBuilder(detail::environmentSnapshot()).appendPath("PYTHONPATH", pyPaths).build();
+        cache.insert(key, env);
+        return env;
+    }
+
+}   // namespace general_util
+
+
+namespace utilWidgets {
+
+    /* Filterable name/value table of an environment, path lists get one entry per line in the tooltip.
+
+    Example usage:
+        EnvironmentView* view = new EnvironmentView(this);
+        view->setEnvironment(process->processEnvironment());
+        view->setFilter("PYTHON");
+    */
+    class EnvironmentView : public QWidget
+    {
+    private:
+        QLineEdit* m_filterEdit = nullptr;
+        QTableView* m_table = nullptr;
+        QLabel* m_countLabel = nullptr;
+        QStandardItemModel* m_model = nullptr;
+        QSortFilterProxyModel* m_proxy = nullptr;
+
+    public:
+        explicit EnvironmentView(QWidget* parent = nullptr) : QWidget(parent) {
+            initUI();
+            setEnvironment(general_util::baseEnvironment());
+        }
+        ~EnvironmentView() = default;
+
+        void initUI() {
+            // controls
+            m_filterEdit = new QLineEdit(this);
+            m_filterEdit->setPlaceholderText("Filter names and values");
+            m_filterEdit->setClearButtonEnabled(true);
+
+            m_countLabel = new QLabel(this);
+
+            m_model = new QStandardItemModel(0, 2, this);
+            m_model->setHorizontalHeaderLabels({"Name", "Value"});
+
+            m_proxy = new QSortFilterProxyModel(this);
+            m_proxy->setSourceModel(m_model);
+            m_proxy->setFilterKeyColumn(-1);
+            m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+            m_proxy->setSortCaseSensitivity(Qt::CaseInsensitive);
+
+            m_table = new QTableView(this);
+            m_table->setModel(m_proxy);
+            m_table->setSortingEnabled(true);
+            m_table->sortByColumn(0, Qt::AscendingOrder);
+            m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+            m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+            m_table->setWordWrap(false);
+            m_table->verticalHeader()->hide();
+            m_table->horizontalHeader()->setStretchLastSection(true);
+
+            // layouts
+            QVBoxLayout* lay = new QVBoxLayout(this);
+            lay->setSpacing(2);
+            lay->setContentsMargins(1,1,1,1);
+            setLayout(lay);
+
+            lay->addWidget(m_filterEdit);
+            lay->addWidget(m_table);
+            lay->addWidget(m_countLabel);
+
+            // connections
+            connect(m_filterEdit, &QLineEdit::textChanged, this, [this](const QString& text) {
+                m_proxy->setFilterFixedString(text);
+                updateCount();
+            });
+        }
+
+        void setEnvironment(const QProcessEnvironment& env) {
+            m_model->removeRows(0, m_model->rowCount());
+            const QStringList keys = env.keys();
+            for (const QString& key : keys) {
+                const QString value = env.value(key);
+                QStandardItem* valueItem = new QStandardItem(value);
+
+                const QStringList paths = general_util::splitPathList(value);
+                if (paths.count() > 1) {
+                    valueItem->setToolTip(paths.join('\n'));
+                }
+                m_model->appendRow({new QStandardItem(key), valueItem});
+            }
+            m_table->resizeColumnToContents(0);
+            updateCount();
+        }
+
+        void setFilter(const QString& text) {
+            m_filterEdit->setText(text);
+        }
+
+        virtual QSize sizeHint() const override { return QSize(640, 480); }
+
+    private:
+        void updateCount() {
+            m_countLabel->setText(QString("%1 / %2 variables").arg(m_proxy->rowCount()).arg(m_model->rowCount()));
+        }
+    };
+
+}   // namespace utilWidgets
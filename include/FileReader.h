@@ -0,0 +1,269 @@
+#pragma once
+#include <QFile>
+#include <QFuture>
+#include <QByteArray>
+#include <QStringList>
+#include <QByteArrayView>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+namespace general_util {
+
+    /* Decode file contents as text the way QIODevice::Text + QTextStream did:
+    UTF-8, a leading BOM dropped, "\r\n" turned into "\n".
+    */
+    inline QString decodeText(QByteArrayView bytes) {
+        if (bytes.startsWith("\xEF\xBB\xBF")) bytes = bytes.mid(3);
+        QString text = QString::fromUtf8(bytes);
+        if (bytes.contains('\r')) text.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+        return text;
+    }
+
+
+    /* Read-only memory mapping of a whole file. bytes() points straight into the mapping,
+    nothing is copied and pages are only read from disk when they are touched.
+    The view is valid until close() or destruction.
+
+    Example usage:
+        MappedFile file;
+        if (!file.open(path)) {
+            qWarning() << file.errorString();
+            return;
+        }
+        const QByteArrayView header = file.bytes().first(qMin<qint64>(file.size(), 512));
+    */
+    class MappedFile
+    {
+    private:
+        QFile m_file;
+        const char* m_data = nullptr;
+        qint64 m_size = 0;
+        QString m_error;
+
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const QString& path) { open(path); }
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // an empty file opens fine and maps nothing
+        bool open(const QString& path) {
+            close();
+            m_file.setFileName(path);
+            if (!m_file.open(QIODevice::ReadOnly)) {
+                m_error = m_file.errorString();
+                return false;
+            }
+
+            m_size = m_file.size();
+            if (m_size > 0) {
+                m_data = reinterpret_cast<const char*>(m_file.map(0, m_size));
+                if (m_data == nullptr) {
+                    m_error = m_file.errorString();
+                    m_file.close();
+                    m_size = 0;
+                    return false;
+                }
+            }
+            m_error.clear();
+            return true;
+        }
+
+        void close() {
+            if (m_data) m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+            m_data = nullptr;
+            m_size = 0;
+            m_file.close();
+        }
+
+        bool isOpen() const { return m_file.isOpen(); }
+        QString fileName() const { return m_file.fileName(); }
+        QString errorString() const { return m_error; }
+
+        const char* data() const { return m_data; }
+        qint64 size() const { return m_size; }
+        QByteArrayView bytes() const { return QByteArrayView(m_data, m_size); }
+    };
+
+
+    /* Reads a file line by line through a fixed-size chunk buffer, so memory stays bounded
+    by ChunkSize + maxLineLength whatever the file size, and only the chunks actually
+    consumed are read. Works on pipes and /proc entries, which cannot be mapped.
+    Line endings ("\n" or "\r\n") are stripped; longer lines are returned in pieces.
+
+    Example usage:
+        LineReader reader(path);
+        QString line;
+        while (reader.lineNumber() < 100 && reader.readLine(line)) {
+            ...
+        }
+        if (reader.hasError()) qWarning() << reader.errorString();
+    */
+    class LineReader
+    {
+    public:
+        static constexpr qint64 ChunkSize = 64 * 1024;
+
+    private:
+        QFile m_file;
+        QByteArray m_buffer;
+        qsizetype m_pos = 0;
+        qint64 m_lineNumber = 0;
+        int m_maxLineLength = 1024 * 1024;
+        bool m_eof = true;
+        QString m_error;
+
+    public:
+        LineReader() = default;
+        explicit LineReader(const QString& path) { open(path); }
+
+        LineReader(const LineReader&) = delete;
+        LineReader& operator=(const LineReader&) = delete;
+
+        bool open(const QString& path) {
+            close();
+            m_file.setFileName(path);
+            // the chunk buffer replaces QFile's own buffering
+            if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+                m_error = m_file.errorString();
+                return false;
+            }
+            m_eof = false;
+            return true;
+        }
+
+        void close() {
+            m_file.close();
+            m_buffer.clear();
+            m_pos = 0;
+            m_lineNumber = 0;
+            m_eof = true;
+            m_error.clear();
+        }
+
+        void setMaxLineLength(const int length) { m_maxLineLength = qMax(1, length); }
+
+        // the next line without its line ending, false at the end of the file or on a read error
+        bool readLine(QByteArray& line) {
+            line.clear();
+            while (true) {
+                if (m_eof && m_pos >= m_buffer.size()) return false;
+
+                const qsizetype newline = m_buffer.indexOf('\n', m_pos);
+                const qsizetype end = newline >= 0 ? newline : (m_eof ? m_buffer.size() : -1);
+                if (end >= 0) {
+                    qsizetype length = end - m_pos;
+                    if (length > 0 && m_buffer.at(end - 1) == '\r') length --;
+                    if (length <= m_maxLineLength) {
+                        line = m_buffer.mid(m_pos, length);
+                        m_pos = end + 1;
+                        ++m_lineNumber;
+                        return true;
+                    }
+                }
+                // a piece is only split off once the line is certainly longer, not between '\r' and '\n'
+                if (end >= 0 || m_buffer.size() - m_pos >= qsizetype(m_maxLineLength) + 2) {
+                    line = m_buffer.mid(m_pos, m_maxLineLength);
+                    m_pos += m_maxLineLength;
+                    ++m_lineNumber;
+                    return true;
+                }
+                fill();
+            }
+        }
+
+        bool readLine(QString& line) {
+            QByteArray bytes;
+            if (!readLine(bytes)) {
+                line.clear();
+                return false;
+            }
+            line = QString::fromUtf8(bytes);
+            return true;
+        }
+
+        // lines returned so far
+        qint64 lineNumber() const { return m_lineNumber; }
+
+        bool atEnd() const { return m_eof && m_pos >= m_buffer.size(); }
+        bool hasError() const { return !m_error.isEmpty(); }
+        QString errorString() const { return m_error; }
+
+    private:
+        void fill() {
+            m_buffer.remove(0, m_pos);
+            m_pos = 0;
+
+            const qsizetype used = m_buffer.size();
+            m_buffer.resize(used + ChunkSize);
+            qint64 n = m_file.read(m_buffer.data() + used, ChunkSize);
+            if (n < 0) {
+                m_error = m_file.errorString();
+                n = 0;
+            }
+            m_buffer.resize(used + n);
+            if (n == 0) m_eof = true;
+        }
+    };
+
+
+    struct FileReadResult
+    {
+        QString path;
+        QByteArray data;
+        QString error;                  // empty on success
+
+        bool ok() const { return error.isEmpty(); }
+        QString text() const { return decodeText(data); }
+    };
+
+    /* Read up to 'maxBytes' (everything when negative) of a file.
+    */
+    inline FileReadResult readFile(const QString& path, const qint64 maxBytes = -1) {
+        FileReadResult result;
+        result.path = path;
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            result.error = file.errorString();
+            return result;
+        }
+        result.data = maxBytes < 0 ? file.readAll() : file.read(maxBytes);
+        if (file.error() != QFileDevice::NoError) {
+            result.error = file.errorString();
+            result.data.clear();
+        }
+        return result;
+    }
+
+    /* readFile() on the global thread pool.
+
+    Example usage:
+        QFutureWatcher<general_util::FileReadResult>* watcher = new QFutureWatcher<general_util::FileReadResult>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [watcher]() {
+            const general_util::FileReadResult result = watcher->result();
+            watcher->deleteLater();
+            ...
+        });
+        watcher->setFuture(general_util::readFileAsync(path));
+    */
+    inline QFuture<FileReadResult> readFileAsync(const QString& path, const qint64 maxBytes = -1) {
+        return QtConcurrent::run([path, maxBytes]() { return readFile(path, maxBytes); });
+    }
+
+    /* The first 'maxLines' lines of a file (all of them when negative),
+    only the chunks holding them are read.
+    */
+    inline QStringList readLines(const QString& path, const qint64 maxLines = -1, QString* error = nullptr) {
+        QStringList result;
+        LineReader reader(path);
+        QString line;
+        while ((maxLines < 0 || reader.lineNumber() < maxLines) && reader.readLine(line))
+            result.append(line);
+        if (error) *error = reader.errorString();
+        return result;
+    }
+
+}   // namespace general_util
@@ -0,0 +1,2135 @@
+#pragma once
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <QDir>
+#include <QMenu>
+#include <QList>
+#include <QFile>
+#include <QMutex>
+#include <QColor>
+#include <QLabel>
+#include <QStyle>
+#include <QTimer>
+#include <QFuture>
+#include <QVector>
+#include <QThread>
+#include <QWidget>
+#include <QProcess>
+#include <QPointer>
+#include <QPainter>
+#include <QFileInfo>
+#include <QLineEdit>
+#include <QDateTime>
+#include <QKeyEvent>
+#include <QClipboard>
+#include <QScrollBar>
+#include <QToolButton>
+#include <QThreadPool>
+#include <QMouseEvent>
+#include <QPushButton>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QFontDatabase>
+#include <QWaitCondition>
+#include <QStringDecoder>
+#include <QVarLengthArray>
+#include <QGuiApplication>
+#include <QCoreApplication>
+#include <QRegularExpression>
+#include <QAbstractScrollArea>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+namespace utilWidgets {
+
+    enum class LogLevel : quint8 {
+        Debug = 0,
+        Info,
+        Warning,
+        Error,
+        Fatal
+    };
+
+    inline QString logLevelName(const LogLevel level) {
+        switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Fatal: return "FATAL";
+        default: return "INFO";
+        }
+    }
+
+    inline QColor logLevelColor(const LogLevel level, const QColor& fallback) {
+        switch (level) {
+        case LogLevel::Debug: return QColor("#9a9a9a");
+        case LogLevel::Warning: return QColor("#FF8000");
+        case LogLevel::Error:
+        case LogLevel::Fatal: return QColor("#ff5050");
+        default: return fallback;
+        }
+    }
+
+    // styled part of a log line, invalid colors use the default ones
+    struct LogSpan {
+        int start = 0;
+        int length = 0;
+        QColor foreground;
+        QColor background;
+        bool bold = false;
+    };
+
+    struct LogLine {
+        QString text;
+        LogLevel level = LogLevel::Info;
+        QString source;
+        QVector<LogSpan> spans;     // empty for plain lines
+    };
+
+
+    /* Fixed capacity FIFO keeping the most recent items.
+    Every pushed item gets a running sequence number, so positions stay valid while old items are dropped.
+    Items live in fixed-size chunks that are written once and dropped whole, never reallocated,
+    so a copy shares them: copying costs one pointer per chunk, and the original can keep pushing
+    while the copy is read on another thread (new items only go to slots the copy never reads).
+    */
+    template <typename T>
+    class RingBuffer
+    {
+    private:
+        using Chunk = std::vector<T>;
+
+        QList<std::shared_ptr<Chunk>> m_chunks;
+        int m_capacity = 0;
+        int m_chunkSize = 0;
+        qint64 m_firstChunk = 0;    // chunk number of m_chunks.first(), item 'seq' is in chunk seq / m_chunkSize
+        qint64 m_first = 0;         // sequence number of the oldest item
+        qint64 m_end = 0;           // sequence number of the next item
+
+    public:
+        explicit RingBuffer(const int capacity = 100000)
+            : m_capacity(qMax(1, capacity)), m_chunkSize(qBound(1, capacity, 1024)) {}
+
+        int capacity() const { return m_capacity; }
+
+        // keeps the most recent items that still fit
+        void setCapacity(const int capacity) {
+            m_capacity = qMax(1, capacity);
+            m_first = qMax(m_first, m_end - m_capacity);
+            dropChunks();
+        }
+
+        int count() const { return static_cast<int>(m_end - m_first); }
+        bool isEmpty() const { return m_end == m_first; }
+
+        qint64 firstSequence() const { return m_first; }
+        qint64 endSequence() const { return m_end; }
+        bool containsSequence(const qint64 seq) const { return seq >= m_first && seq < m_end; }
+
+        // returns the number of items dropped to make room (0 or 1)
+        int push(const T& item) {
+            const qint64 chunk = m_end / m_chunkSize;
+            if (m_chunks.isEmpty()) m_firstChunk = chunk;
+            if (chunk - m_firstChunk >= m_chunks.count())
+                m_chunks.append(std::make_shared<Chunk>(m_chunkSize));
+            (*m_chunks.at(chunk - m_firstChunk))[m_end % m_chunkSize] = item;
+            m_end ++;
+
+            if (m_end - m_first <= m_capacity) return 0;
+            m_first ++;
+            dropChunks();
+            return 1;
+        }
+
+        // logical index, 0 is the oldest item
+        const T& at(const int index) const {
+            return atSequence(m_first + index);
+        }
+
+        const T& atSequence(const qint64 seq) const {
+            return (*m_chunks.at(seq / m_chunkSize - m_firstChunk))[seq % m_chunkSize];
+        }
+
+        // sequence numbers keep increasing across clear()
+        void clear() {
+            m_first = m_end;
+            m_chunks.clear();
+        }
+
+    private:
+        // chunks holding no live item; copies may still hold them
+        void dropChunks() {
+            if (isEmpty()) {
+                m_chunks.clear();
+                return;
+            }
+            while (!m_chunks.isEmpty() && m_firstChunk < m_first / m_chunkSize) {
+                m_chunks.removeFirst();
+                m_firstChunk ++;
+            }
+        }
+    };
+
+
+    /* Unbounded multi-producer / single-consumer queue.
+    push() is a single atomic exchange, any number of threads may push concurrently,
+    pop() must only be called from one consumer thread.
+    */
+    template <typename T>
+    class MpscQueue
+    {
+    private:
+        struct Node {
+            std::atomic<Node*> next{nullptr};
+            T value;
+        };
+
+        std::atomic<Node*> m_head;      // producers append here
+        Node* m_tail = nullptr;         // consumer side, always a consumed (stub) node
+
+    public:
+        MpscQueue() {
+            m_tail = new Node();
+            m_head.store(m_tail, std::memory_order_relaxed);
+        }
+
+        ~MpscQueue() {
+            T value;
+            while (pop(value)) {}
+            delete m_tail;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        void push(T value) {
+            Node* node = new Node();
+            node->value = std::move(value);
+            Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        bool pop(T& value) {
+            Node* next = m_tail->next.load(std::memory_order_acquire);
+            if (next == nullptr) return false;
+
+            value = std::move(next->value);
+            delete m_tail;
+            m_tail = next;
+            return true;
+        }
+    };
+
+
+    struct LogRecord {
+        LogLevel level = LogLevel::Info;
+        qint64 timestamp = 0;       // ms since epoch
+        quintptr threadId = 0;
+        QString category;
+        QString text;
+    };
+
+
+    /* Process-wide log entry point usable from any thread.
+    Records go through a lock-free MpscQueue and are drained on the GUI thread by the
+    attached LogView once per frame; producers never wait on a mutex or on the GUI.
+    installMessageHandler() also routes qDebug()/qWarning()/... into the sink.
+
+    Example usage:
+        logView->attachSink();                          // this view drains LogSink::instance()
+        utilWidgets::LogSink::installMessageHandler();  // optional qDebug() bridge
+
+        // from any thread
+        utilWidgets::LogSink::instance().log(utilWidgets::LogLevel::Warning, "cache miss", "render");
+    */
+    class LogSink
+    {
+    private:
+        MpscQueue<LogRecord> m_queue;
+        std::atomic<qint64> m_size{0};
+        std::atomic<qint64> m_dropped{0};
+        std::atomic<bool> m_wakePending{false};
+        qint64 m_maxPending = 1000000;
+        std::function<void()> m_consumer;   // GUI thread only
+
+        static QtMessageHandler& previousHandler() {
+            static QtMessageHandler handler = nullptr;
+            return handler;
+        }
+
+        static std::atomic<bool>& chainHandler() {
+            static std::atomic<bool> chain{true};
+            return chain;
+        }
+
+    public:
+        LogSink() = default;
+        ~LogSink() = default;
+
+        static LogSink& instance() {
+            static LogSink sink;
+            return sink;
+        }
+
+        /* Thread-safe and lock-free. Records beyond the pending limit are dropped and counted.
+        */
+        void log(const LogLevel level, const QString& text, const QString& category = QString()) {
+            if (m_size.fetch_add(1, std::memory_order_relaxed) >= m_maxPending) {
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            LogRecord record;
+            record.level = level;
+            record.timestamp = QDateTime::currentMSecsSinceEpoch();
+            record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+            record.category = category;
+            record.text = text;
+            m_queue.push(std::move(record));
+
+            // one wake up per batch, not per record
+            if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+                if (QCoreApplication* app = QCoreApplication::instance()) {
+                    QMetaObject::invokeMethod(app, [this]() {
+                        if (m_consumer) m_consumer();
+                    }, Qt::QueuedConnection);
+                }
+            }
+        }
+
+        /* Consumer side: move up to 'max' records (all when negative) into 'out'.
+        Must only be called from the thread draining the sink (the GUI thread).
+        */
+        int drain(QVector<LogRecord>& out, const int max = -1) {
+            m_wakePending.store(false, std::memory_order_release);
+
+            int count = 0;
+            LogRecord record;
+            while ((max < 0 || count < max) && m_queue.pop(record)) {
+                out.append(std::move(record));
+                count ++;
+            }
+            m_size.fetch_sub(count, std::memory_order_relaxed);
+            return count;
+        }
+
+        // returns and resets the number of records dropped because nobody drained the sink
+        qint64 takeDroppedCount() {
+            return m_dropped.exchange(0, std::memory_order_relaxed);
+        }
+
+        void setMaxPending(const qint64 count) { m_maxPending = qMax<qint64>(1, count); }
+
+        /* Called on the GUI thread whenever records arrive after a drain. GUI thread only.
+        */
+        void setConsumer(std::function<void()> consumer) {
+            m_consumer = std::move(consumer);
+            if (m_consumer) m_consumer();
+        }
+
+        static QString format(const LogRecord& record) {
+            QString result = QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("hh:mm:ss.zzz");
+            result += " [" + logLevelName(record.level) + "]";
+            result += QString(" [%1]").arg(record.threadId, 0, 16);
+            if (!record.category.isEmpty())
+                result += " [" + record.category + "]";
+            result += " " + record.text;
+            return result;
+        }
+
+        static LogLevel levelFromMsgType(const QtMsgType type) {
+            switch (type) {
+            case QtDebugMsg: return LogLevel::Debug;
+            case QtInfoMsg: return LogLevel::Info;
+            case QtWarningMsg: return LogLevel::Warning;
+            case QtCriticalMsg: return LogLevel::Error;
+            default: return LogLevel::Fatal;
+            }
+        }
+
+        /* Route Qt's message output (qDebug, qInfo, qWarning, qCritical, qFatal) into the sink.
+        With 'chain', messages are passed on to the previously installed handler as well.
+        */
+        static void installMessageHandler(const bool chain = true) {
+            chainHandler().store(chain);
+            QtMessageHandler previous = qInstallMessageHandler(&LogSink::messageHandler);
+            if (previous != &LogSink::messageHandler)
+                previousHandler() = previous;
+        }
+
+        static void uninstallMessageHandler() {
+            qInstallMessageHandler(previousHandler());
+            previousHandler() = nullptr;
+        }
+
+    private:
+        static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg) {
+            const char* category = context.category;
+            const bool defaultCategory = category == nullptr || qstrcmp(category, "default") == 0;
+            instance().log(levelFromMsgType(type), msg, defaultCategory ? QString() : QString::fromLatin1(category));
+
+            if (chainHandler().load() && previousHandler())
+                previousHandler()(type, context, msg);
+        }
+    };
+
+
+    /* Reads the level and the source from the leading tags of a line, e.g.
+    "12:00:01 [WARNING] [render] text", "[error] text" or "ERROR: text".
+    'level' and 'source' are left untouched when no tag is found.
+    */
+    inline void parseLogTags(QStringView line, LogLevel& level, QString& source) {
+        auto levelFromTag = [](QStringView tag, LogLevel& out) {
+            auto is = [&tag](const char16_t* name) { return tag.compare(QStringView(name), Qt::CaseInsensitive) == 0; };
+            if (is(u"debug") || is(u"trace")) out = LogLevel::Debug;
+            else if (is(u"info")) out = LogLevel::Info;
+            else if (is(u"warning") || is(u"warn")) out = LogLevel::Warning;
+            else if (is(u"error") || is(u"err") || is(u"critical")) out = LogLevel::Error;
+            else if (is(u"fatal")) out = LogLevel::Fatal;
+            else return false;
+            return true;
+        };
+        auto isHex = [](QStringView tag) {
+            for (QChar c : tag) {
+                if (!c.isDigit() && !(c.toLower() >= QLatin1Char('a') && c.toLower() <= QLatin1Char('f'))) return false;
+            }
+            return true;
+        };
+        auto isTimestamp = [](QStringView word) {
+            for (QChar c : word) {
+                if (!c.isDigit() && c != QLatin1Char(':') && c != QLatin1Char('.') && c != QLatin1Char('-')
+                    && c != QLatin1Char('T') && c != QLatin1Char('/'))
+                    return false;
+            }
+            return !word.isEmpty();
+        };
+
+        const int limit = static_cast<int>(qMin<qsizetype>(line.size(), 128));
+        bool levelFound = false;
+        int pos = 0;
+
+        // look at a few leading tokens only: timestamps, [tags] and "LEVEL:"
+        for (int token = 0; token < 5 && pos < limit; ++token) {
+            while (pos < limit && line[pos].isSpace()) pos ++;
+            if (pos >= limit) break;
+
+            if (line[pos] == QLatin1Char('[')) {
+                const int end = static_cast<int>(line.indexOf(QLatin1Char(']'), pos + 1));
+                if (end < 0 || end > limit) break;
+
+                QStringView tag = line.mid(pos + 1, end - pos - 1).trimmed();
+                LogLevel parsed;
+                if (!levelFound && levelFromTag(tag, parsed)) {
+                    level = parsed;
+                    levelFound = true;
+                } else if (levelFound && !tag.isEmpty() && !isHex(tag) && !isTimestamp(tag)) {
+                    source = tag.toString();
+                    break;
+                }
+                pos = end + 1;
+                continue;
+            }
+
+            int end = pos;
+            while (end < limit && !line[end].isSpace()) end ++;
+            QStringView word = line.mid(pos, end - pos);
+            if (word.endsWith(QLatin1Char(':')) && !levelFound) {
+                LogLevel parsed;
+                if (levelFromTag(word.chopped(1), parsed)) level = parsed;
+                break;
+            }
+            if (!isTimestamp(word)) break;
+            pos = end;
+        }
+    }
+
+
+    /* Incremental ANSI escape sequence parser.
+    SGR color/bold codes become LogSpans, every other CSI/OSC sequence is stripped.
+    The current style carries over from one line to the next, like in a terminal.
+    */
+    class AnsiParser
+    {
+    private:
+        QColor m_fg;
+        QColor m_bg;
+        bool m_bold = false;
+
+    public:
+        void reset() {
+            m_fg = QColor();
+            m_bg = QColor();
+            m_bold = false;
+        }
+
+        // strip the escape sequences from 'raw' and fill the text and spans of 'line'
+        void parseLine(QStringView raw, LogLine& line) {
+            line.text.clear();
+            line.spans.clear();
+            if (!raw.contains(QChar(0x1b))) {
+                line.text = raw.toString();
+                if (isStyled()) line.spans.append({0, int(raw.size()), m_fg, m_bg, m_bold});
+                return;
+            }
+
+            line.text.reserve(raw.size());
+            bool styled = false;
+            int spanStart = 0;
+            auto closeSpan = [&]() {
+                const int end = int(line.text.size());
+                if (end > spanStart) line.spans.append({spanStart, end - spanStart, m_fg, m_bg, m_bold});
+                styled = styled || isStyled();
+                spanStart = end;
+            };
+
+            qsizetype i = 0;
+            while (i < raw.size()) {
+                const qsizetype esc = raw.indexOf(QChar(0x1b), i);
+                if (esc < 0) {
+                    line.text.append(raw.mid(i));
+                    break;
+                }
+                line.text.append(raw.mid(i, esc - i));
+                i = esc + 1;
+                if (i >= raw.size()) break;
+
+                if (raw[i] == QLatin1Char('[')) {
+                    // CSI: parameters up to a final byte in 0x40..0x7e
+                    qsizetype end = i + 1;
+                    while (end < raw.size() && (raw[end].unicode() < 0x40 || raw[end].unicode() > 0x7e)) end ++;
+                    if (end >= raw.size()) break;
+                    if (raw[end] == QLatin1Char('m')) {
+                        closeSpan();
+                        applySgr(raw.mid(i + 1, end - i - 1));
+                    }
+                    i = end + 1;
+                } else if (raw[i] == QLatin1Char(']')) {
+                    // OSC: up to BEL or ESC '\'
+                    qsizetype end = i + 1;
+                    while (end < raw.size() && raw[end] != QChar(0x07) && raw[end] != QChar(0x1b)) end ++;
+                    i = (end < raw.size() && raw[end] == QChar(0x1b)) ? end + 2 : end + 1;
+                } else {
+                    i ++;
+                }
+            }
+            closeSpan();
+            if (!styled) line.spans.clear();
+        }
+
+        bool isStyled() const {
+            return m_fg.isValid() || m_bg.isValid() || m_bold;
+        }
+
+        static QColor standardColor(const int index) {
+            static const QRgb colors[16] = {
+                0x000000, 0xcd3131, 0x0dbc79, 0xe5e510, 0x2472c8, 0xbc3fbc, 0x11a8cd, 0xe5e5e5,
+                0x666666, 0xf14c4c, 0x23d18b, 0xf5f543, 0x3b8eea, 0xd670d6, 0x29b8db, 0xffffff
+            };
+            return QColor(colors[qBound(0, index, 15)]);
+        }
+
+        // xterm 256 color palette
+        static QColor paletteColor(const int index) {
+            if (index < 16) return standardColor(index);
+            if (index < 232) {
+                const int c = index - 16;
+                auto level = [](int v) { return v == 0 ? 0 : 55 + v * 40; };
+                return QColor(level(c / 36), level((c / 6) % 6), level(c % 6));
+            }
+            const int gray = 8 + (qMin(index, 255) - 232) * 10;
+            return QColor(gray, gray, gray);
+        }
+
+    private:
+        void applySgr(QStringView params) {
+            QVarLengthArray<int, 16> codes;
+            for (QStringView part : params.split(QLatin1Char(';')))
+                codes.append(part.isEmpty() ? 0 : part.toInt());
+            if (codes.isEmpty()) codes.append(0);
+
+            for (int k = 0; k < codes.size(); ++k) {
+                const int code = codes[k];
+                if (code == 0) reset();
+                else if (code == 1) m_bold = true;
+                else if (code == 22) m_bold = false;
+                else if (code >= 30 && code <= 37) m_fg = standardColor(code - 30);
+                else if (code >= 90 && code <= 97) m_fg = standardColor(code - 90 + 8);
+                else if (code == 39) m_fg = QColor();
+                else if (code >= 40 && code <= 47) m_bg = standardColor(code - 40);
+                else if (code >= 100 && code <= 107) m_bg = standardColor(code - 100 + 8);
+                else if (code == 49) m_bg = QColor();
+                else if (code == 38 || code == 48) {
+                    QColor color;
+                    if (k + 2 < codes.size() && codes[k + 1] == 5) {
+                        color = paletteColor(codes[k + 2]);
+                        k += 2;
+                    } else if (k + 4 < codes.size() && codes[k + 1] == 2) {
+                        color = QColor(qBound(0, codes[k + 2], 255), qBound(0, codes[k + 3], 255), qBound(0, codes[k + 4], 255));
+                        k += 4;
+                    }
+                    (code == 38 ? m_fg : m_bg) = color;
+                }
+            }
+        }
+    };
+
+
+    /* Sorted list of sequence numbers, trimmed from the front as the ring buffer drops lines.
+    */
+    class SequenceIndex
+    {
+    private:
+        QVector<qint64> m_seqs;
+        int m_head = 0;
+
+    public:
+        int count() const { return m_seqs.count() - m_head; }
+        bool isEmpty() const { return count() == 0; }
+        qint64 at(const int index) const { return m_seqs.at(m_head + index); }
+
+        void append(const qint64 seq) { m_seqs.append(seq); }
+
+        void clear() {
+            m_seqs.clear();
+            m_head = 0;
+        }
+
+        // drop everything below 'first', returns the number of entries dropped
+        int trim(const qint64 first) {
+            const auto begin = m_seqs.cbegin() + m_head;
+            const int dropped = static_cast<int>(std::lower_bound(begin, m_seqs.cend(), first) - begin);
+            m_head += dropped;
+            if (m_head > 4096 && m_head > m_seqs.count() / 2) {
+                m_seqs.remove(0, m_head);
+                m_head = 0;
+            }
+            return dropped;
+        }
+
+        // index of the first entry >= seq
+        int lowerBound(const qint64 seq) const {
+            const auto begin = m_seqs.cbegin() + m_head;
+            return static_cast<int>(std::lower_bound(begin, m_seqs.cend(), seq) - begin);
+        }
+
+        QVector<qint64> toVector() const {
+            return m_seqs.mid(m_head);
+        }
+
+        void assign(QVector<qint64> seqs) {
+            m_seqs = std::move(seqs);
+            m_head = 0;
+        }
+    };
+
+
+    /* Appends log lines to a file from a background writer thread, rotating the file by size.
+    Writers only append to an in-memory batch, the thread writes everything pending in one go,
+    so the GUI never waits on the disk. Rotation shifts "app.log" to "app.1.log", "app.1.log"
+    to "app.2.log" and so on, the oldest file beyond 'maxFiles' is removed.
+    */
+    class RotatingFileSink
+    {
+    public:
+        static constexpr int MaxPendingBytes = 32 * 1024 * 1024;
+
+    private:
+        const QString m_path;
+        const qint64 m_maxBytes;
+        const int m_maxFiles;
+
+        mutable QMutex m_mutex;
+        QWaitCondition m_wake;
+        QByteArray m_pending;
+        qint64 m_dropped = 0;
+        bool m_stop = false;
+        QString m_error;
+        QThread* m_thread = nullptr;
+
+    public:
+        explicit RotatingFileSink(const QString& path, const qint64 maxBytes = 64 * 1024 * 1024, const int maxFiles = 5)
+            : m_path(path), m_maxBytes(qMax<qint64>(1024, maxBytes)), m_maxFiles(qMax(0, maxFiles)) {
+            m_thread = QThread::create([this]() { run(); });
+            m_thread->start(QThread::LowPriority);
+        }
+
+        // writes what is still pending before returning
+        ~RotatingFileSink() {
+            {
+                QMutexLocker locker(&m_mutex);
+                m_stop = true;
+                m_wake.wakeOne();
+            }
+            m_thread->wait();
+            delete m_thread;
+        }
+
+        RotatingFileSink(const RotatingFileSink&) = delete;
+        RotatingFileSink& operator=(const RotatingFileSink&) = delete;
+
+        QString path() const { return m_path; }
+
+        QString errorString() const {
+            QMutexLocker locker(&m_mutex);
+            return m_error;
+        }
+
+        /* Queue UTF-8 text, one or more lines each ending with '\n'.
+        Past MaxPendingBytes (the disk can not keep up) the text is dropped and counted.
+        */
+        void write(const QByteArray& text) {
+            if (text.isEmpty()) return;
+            QMutexLocker locker(&m_mutex);
+            if (m_pending.size() + text.size() > MaxPendingBytes) {
+                m_dropped += text.count('\n');
+                return;
+            }
+            const bool wasEmpty = m_pending.isEmpty();
+            m_pending.append(text);
+            if (wasEmpty) m_wake.wakeOne();
+        }
+
+        void writeLine(const QString& line) {
+            write(line.toUtf8() + '\n');
+        }
+
+        // file name of the rotated file 'index' ("app.log" -> "app.<index>.log")
+        QString rotatedPath(const int index) const {
+            if (index == 0) return m_path;
+            const QFileInfo info(m_path);
+            QString name = info.completeBaseName() + "." + QString::number(index);
+            if (!info.suffix().isEmpty()) name += "." + info.suffix();
+            return info.dir().filePath(name);
+        }
+
+    private:
+        void run() {
+            QDir().mkpath(QFileInfo(m_path).absolutePath());
+            QFile file(m_path);
+            if (!openFile(file)) return;
+
+            while (true) {
+                QByteArray batch;
+                qint64 dropped = 0;
+                bool stop = false;
+                {
+                    QMutexLocker locker(&m_mutex);
+                    while (m_pending.isEmpty() && m_dropped == 0 && !m_stop)
+                        m_wake.wait(&m_mutex);
+                    batch.swap(m_pending);
+                    std::swap(dropped, m_dropped);
+                    stop = m_stop;
+                }
+                if (dropped > 0)
+                    batch.append(QString("%1 log line(s) dropped, the log file could not keep up\n").arg(dropped).toUtf8());
+
+                if (!batch.isEmpty()) {
+                    if (file.size() > 0 && file.size() + batch.size() > m_maxBytes) {
+                        file.close();
+                        rotate();
+                        if (!openFile(file)) return;
+                    }
+                    if (file.write(batch) != batch.size()) setError(file.errorString());
+                    file.flush();
+                }
+                if (stop) break;
+            }
+        }
+
+        bool openFile(QFile& file) {
+            if (file.open(QIODevice::WriteOnly | QIODevice::Append)) return true;
+            setError(file.errorString());
+
+            // keep draining so writers are not blocked by a dead file
+            QMutexLocker locker(&m_mutex);
+            while (!m_stop) {
+                m_pending.clear();
+                m_wake.wait(&m_mutex);
+            }
+            return false;
+        }
+
+        void rotate() {
+            if (m_maxFiles == 0) {
+                QFile::remove(m_path);
+                return;
+            }
+            QFile::remove(rotatedPath(m_maxFiles));
+            for (int i = m_maxFiles - 1; i >= 0; --i) {
+                if (QFile::exists(rotatedPath(i)))
+                    QFile::rename(rotatedPath(i), rotatedPath(i + 1));
+            }
+        }
+
+        void setError(const QString& error) {
+            QMutexLocker locker(&m_mutex);
+            m_error = error;
+        }
+    };
+
+
+    /* Virtualized plain-text log viewport.
+    Lines live in a bounded RingBuffer, only the visible lines are painted, and appends are
+    buffered and flushed once per frame, so high-rate logging neither reflows a document
+    nor grows memory without bound. Selection works on whole lines (click, shift+click, drag).
+
+    Levels and sources are parsed from line tags on ingest and indexed per level, so
+    level filters switch without rescanning. Regex search runs on a worker thread over
+    a snapshot of the buffer and streams its hits back for next/previous navigation.
+    */
+    class LogViewport : public QAbstractScrollArea
+    {
+    public:
+        static constexpr int LevelCount = 5;
+        static constexpr quint8 AllLevels = 0x1f;
+
+    private:
+        RingBuffer<LogLine> m_lines;
+        QStringList m_pending;
+        QVector<LogLine> m_pendingLines;
+        QTimer* m_flushTimer = nullptr;
+        LogSink* m_sink = nullptr;
+        std::unique_ptr<RotatingFileSink> m_fileSink;
+        QByteArray m_fileBatch;
+
+        int m_maxLineLength = 0;
+        qint64 m_maxLineSeq = -1;       // the longest line, the length is measured again once it is evicted
+        qint64 m_selAnchor = -1;
+        qint64 m_selCursor = -1;
+
+        // level filtering
+        SequenceIndex m_levelIndex[LevelCount];
+        SequenceIndex m_filtered;
+        quint8 m_levelMask = AllLevels;
+
+        // search
+        QRegularExpression m_searchRegex;
+        QVector<qint64> m_hits;
+        int m_currentHit = -1;
+        int m_searchGeneration = 0;
+        bool m_searchRunning = false;
+        std::shared_ptr<std::atomic<bool>> m_searchCancel;
+        std::function<void(int hits, bool finished)> m_searchCallback;
+
+    public:
+        explicit LogViewport(QWidget* parent = nullptr) : QAbstractScrollArea(parent) {
+            initUI();
+        }
+        ~LogViewport() override {
+            writePendingToFile();
+            detachSink();
+            if (m_searchCancel) m_searchCancel->store(true);
+        }
+
+        void initUI() {
+            setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+            setFocusPolicy(Qt::StrongFocus);
+            setContextMenuPolicy(Qt::CustomContextMenu);
+            viewport()->setCursor(Qt::IBeamCursor);
+
+            m_flushTimer = new QTimer(this);
+            m_flushTimer->setSingleShot(true);
+            m_flushTimer->setInterval(16);     // about one flush per frame
+
+            connect(m_flushTimer, &QTimer::timeout, this, [this]() { flush(); });
+            connect(this, &QWidget::customContextMenuRequested, this, [this](const QPoint& pos) {
+                QMenu menu(this);
+                menu.addAction("Copy", this, [this]() { copySelection(); })->setEnabled(hasSelection());
+                menu.addAction("Select All", this, [this]() { selectAll(); });
+                menu.addSeparator();
+                menu.addAction("Clear", this, [this]() { clear(); });
+                menu.exec(mapToGlobal(pos));
+            });
+        }
+
+        /* Queue text for display, it may contain several lines.
+        */
+        void append(const QString& text) {
+            m_pending.append(text);
+            scheduleFlush();
+        }
+
+        void appendLines(const QStringList& lines) {
+            m_pending.append(lines);
+            scheduleFlush();
+        }
+
+        /* Queue already split (and possibly styled) lines, levels are still read from their tags.
+        */
+        void appendLogLines(QVector<LogLine>&& lines) {
+            if (m_pendingLines.isEmpty()) m_pendingLines = std::move(lines);
+            else m_pendingLines.append(lines);
+            scheduleFlush();
+        }
+
+        void scheduleFlush() {
+            if (!m_flushTimer->isActive()) m_flushTimer->start();
+        }
+
+        void clear() {
+            m_pending.clear();
+            m_pendingLines.clear();
+            m_lines.clear();
+            for (SequenceIndex& index : m_levelIndex)
+                index.clear();
+            m_filtered.clear();
+            m_hits.clear();
+            m_currentHit = -1;
+            m_maxLineLength = 0;
+            m_maxLineSeq = -1;
+            clearSelection();
+            updateScrollBars();
+            viewport()->update();
+            if (m_searchCallback) m_searchCallback(0, !m_searchRunning);
+        }
+
+        /* Drain 'sink' (LogSink::instance() by default) into this viewport at frame rate.
+        A sink has a single consumer, attaching replaces the previous one.
+        */
+        void attachSink(LogSink* sink = &LogSink::instance()) {
+            detachSink();
+            m_sink = sink;
+            if (m_sink) m_sink->setConsumer([this]() { scheduleFlush(); });
+        }
+
+        void detachSink() {
+            if (m_sink) m_sink->setConsumer(nullptr);
+            m_sink = nullptr;
+        }
+
+        /* Also write every line to 'path', rotated by size on a background thread.
+        An empty path stops writing; pending lines are written before the old file is closed.
+        */
+        void setLogFile(const QString& path, const qint64 maxBytes = 64 * 1024 * 1024, const int maxFiles = 5) {
+            flush();
+            m_fileSink.reset();
+            if (!path.isEmpty()) m_fileSink = std::make_unique<RotatingFileSink>(path, maxBytes, maxFiles);
+        }
+
+        RotatingFileSink* logFile() const { return m_fileSink.get(); }
+
+        int maximumLineCount() const { return m_lines.capacity(); }
+        void setMaximumLineCount(const int count) {
+            m_lines.setCapacity(count);
+            trimIndices();
+            updateScrollBars();
+            viewport()->update();
+        }
+
+        int lineCount() const { return m_lines.count(); }
+        const RingBuffer<LogLine>& lines() const { return m_lines; }
+
+        // number of lines of 'level' currently in the buffer
+        int levelCount(const LogLevel level) const {
+            return m_levelIndex[int(level)].count();
+        }
+
+        QString toPlainText() const {
+            QStringList result;
+            result.reserve(rowCount());
+            for (int row = 0; row < rowCount(); ++row)
+                result.append(m_lines.atSequence(rowSequence(row)).text);
+            return result.join('\n');
+        }
+
+        bool hasSelection() const {
+            return m_selAnchor >= 0 && m_selCursor >= 0;
+        }
+
+        void clearSelection() {
+            m_selAnchor = -1;
+            m_selCursor = -1;
+            viewport()->update();
+        }
+
+        void selectAll() {
+            if (rowCount() == 0) return;
+            m_selAnchor = rowSequence(0);
+            m_selCursor = rowSequence(rowCount() - 1);
+            viewport()->update();
+        }
+
+        void copySelection() const {
+            if (!hasSelection()) return;
+            const int fromRow = rowOfSequence(qMin(m_selAnchor, m_selCursor));
+            const qint64 to = qMax(m_selAnchor, m_selCursor);
+
+            QStringList result;
+            for (int row = fromRow; row < rowCount() && rowSequence(row) <= to; ++row)
+                result.append(m_lines.atSequence(rowSequence(row)).text);
+            QGuiApplication::clipboard()->setText(result.join('\n'));
+        }
+
+        bool isAtBottom() const {
+            return verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+        }
+
+        void scrollToBottom() {
+            verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        }
+
+        /* Level filter, levels are bits of a mask (1 << int(LogLevel)).
+        Switching only merges the per-level indices, lines are not rescanned.
+        */
+        quint8 levelMask() const { return m_levelMask; }
+
+        bool isLevelVisible(const LogLevel level) const {
+            return m_levelMask & (1 << int(level));
+        }
+
+        void setLevelVisible(const LogLevel level, const bool visible) {
+            const quint8 mask = visible ? (m_levelMask | (1 << int(level))) : (m_levelMask & ~(1 << int(level)));
+            setLevelMask(mask);
+        }
+
+        void setLevelMask(const quint8 mask) {
+            if ((mask & AllLevels) == m_levelMask) return;
+
+            const qint64 top = topSequence();
+            m_levelMask = mask & AllLevels;
+            rebuildFiltered();
+            updateScrollBars();
+            if (top >= 0) verticalScrollBar()->setValue(rowOfSequence(top));
+            viewport()->update();
+        }
+
+        /* Start a regex search over the lines currently in the buffer.
+        Hits stream in through the search callback; an empty pattern clears the search.
+        Returns false when the pattern is invalid.
+        */
+        bool startSearch(const QString& pattern, const bool caseSensitive = false) {
+            cancelSearch();
+            m_hits.clear();
+            m_currentHit = -1;
+            const int generation = ++m_searchGeneration;
+
+            if (pattern.isEmpty()) {
+                m_searchRegex = QRegularExpression();
+                viewport()->update();
+                if (m_searchCallback) m_searchCallback(0, true);
+                return true;
+            }
+
+            QRegularExpression regex(pattern, caseSensitive ? QRegularExpression::NoPatternOption
+                                                            : QRegularExpression::CaseInsensitiveOption);
+            if (!regex.isValid()) {
+                m_searchRegex = QRegularExpression();
+                viewport()->update();
+                if (m_searchCallback) m_searchCallback(0, true);
+                return false;
+            }
+            regex.optimize();
+            m_searchRegex = regex;
+            m_searchRunning = true;
+
+            auto cancel = std::make_shared<std::atomic<bool>>(false);
+            m_searchCancel = cancel;
+
+            // shares the chunks, the GUI keeps appending to its own copy without copying lines
+            const RingBuffer<LogLine> snapshot = m_lines;
+            const quint8 mask = m_levelMask;
+            QPointer<LogViewport> self(this);
+
+            auto post = [self, generation](const QVector<qint64>& hits, bool finished) {
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [self, generation, hits, finished]() {
+                    if (self) self->addSearchHits(generation, hits, finished);
+                }, Qt::QueuedConnection);
+            };
+
+            QThreadPool::globalInstance()->start([snapshot, regex, mask, cancel, post]() {
+                QVector<qint64> hits;
+                QElapsedTimer sincePost;
+                sincePost.start();
+                bool posted = false;
+
+                for (int i = 0; i < snapshot.count(); ++i) {
+                    if ((i & 1023) == 0 && cancel->load(std::memory_order_relaxed)) return;
+
+                    const LogLine& line = snapshot.at(i);
+                    if (!(mask & (1 << int(line.level)))) continue;
+                    if (!regex.match(line.text).hasMatch()) continue;
+
+                    hits.append(snapshot.firstSequence() + i);
+                    // first hit right away, then in batches
+                    if (!posted || sincePost.elapsed() >= 30) {
+                        post(hits, false);
+                        hits.clear();
+                        posted = true;
+                        sincePost.restart();
+                    }
+                }
+                post(hits, true);
+            });
+            return true;
+        }
+
+        void cancelSearch() {
+            if (m_searchCancel) m_searchCancel->store(true);
+            m_searchCancel.reset();
+            m_searchRunning = false;
+        }
+
+        bool isSearching() const { return m_searchRunning; }
+        int searchHitCount() const { return m_hits.count(); }
+        int currentSearchHit() const { return m_currentHit; }
+
+        void setSearchCallback(std::function<void(int hits, bool finished)> callback) {
+            m_searchCallback = std::move(callback);
+        }
+
+        /* Select and scroll to the next (or previous) search hit, wrapping around.
+        */
+        void findNext(const bool backward = false) {
+            trimHits();
+            if (m_hits.isEmpty()) return;
+
+            qint64 from = -1;
+            if (m_currentHit >= 0 && m_currentHit < m_hits.count()) {
+                from = m_hits.at(m_currentHit);
+            } else if (hasSelection()) {
+                from = m_selCursor;
+            } else {
+                from = backward ? m_lines.endSequence() : m_lines.firstSequence() - 1;
+            }
+
+            const int n = m_hits.count();
+            int index = static_cast<int>(backward
+                ? std::lower_bound(m_hits.cbegin(), m_hits.cend(), from) - m_hits.cbegin() - 1
+                : std::upper_bound(m_hits.cbegin(), m_hits.cend(), from) - m_hits.cbegin());
+
+            // skip hits hidden by the level filter
+            for (int tries = 0; tries < n; ++tries) {
+                index = (index % n + n) % n;
+                const qint64 seq = m_hits.at(index);
+                if (isLevelVisible(m_lines.atSequence(seq).level)) {
+                    m_currentHit = index;
+                    m_selAnchor = seq;
+                    m_selCursor = seq;
+                    ensureSequenceVisible(seq);
+                    viewport()->update();
+                    if (m_searchCallback) m_searchCallback(n, !m_searchRunning);
+                    return;
+                }
+                index += backward ? -1 : 1;
+            }
+        }
+
+        void findPrevious() {
+            findNext(true);
+        }
+
+        void ensureSequenceVisible(const qint64 seq) {
+            const int row = rowOfSequence(seq);
+            const int first = verticalScrollBar()->value();
+            if (row < first || row >= first + visibleRowCount())
+                verticalScrollBar()->setValue(row - visibleRowCount() / 2);
+        }
+
+        /* Move the pending text into the ring buffer and repaint once.
+        Called by the frame timer, call it directly to force an immediate update.
+        */
+        void flush() {
+            m_flushTimer->stop();
+
+            QVector<LogRecord> records;
+            if (m_sink) {
+                m_sink->drain(records);
+                if (const qint64 lost = m_sink->takeDroppedCount())
+                    records.append({LogLevel::Warning, QDateTime::currentMSecsSinceEpoch(), 0, QString(),
+                                    QString("%1 log record(s) dropped").arg(lost)});
+            }
+            if (m_pending.isEmpty() && m_pendingLines.isEmpty() && records.isEmpty()) return;
+
+            const bool follow = isAtBottom();
+            const qint64 top = follow ? -1 : topSequence();
+
+            const QStringList pending = std::move(m_pending);
+            m_pending = QStringList();
+            for (const QString& text : pending) {
+                pushText(text, LogLevel::Info, QString(), true);
+            }
+            // lines that would be evicted within this flush anyway are skipped
+            const QVector<LogLine> lines = std::move(m_pendingLines);
+            m_pendingLines = QVector<LogLine>();
+            const int skipped = qMax(0, int(lines.count()) - m_lines.capacity());
+            for (int i = 0; i < skipped && m_fileSink; ++i) {
+                m_fileBatch += lines.at(i).text.toUtf8() + '\n';
+            }
+            for (int i = skipped; i < lines.count(); ++i) {
+                pushLine(lines.at(i), true);
+            }
+            for (const LogRecord& record : records) {
+                pushText(LogSink::format(record), record.level, record.category, false);
+            }
+            trimIndices();
+
+            if (m_fileSink && !m_fileBatch.isEmpty()) {
+                m_fileSink->write(m_fileBatch);
+                m_fileBatch.clear();
+            }
+
+            updateScrollBars();
+            if (follow) {
+                scrollToBottom();
+            } else if (top >= 0) {
+                // keep the same lines on screen while old ones scroll out of the buffer
+                verticalScrollBar()->setValue(rowOfSequence(top));
+            }
+            viewport()->update();
+        }
+
+    protected:
+        // what has not been flushed yet still belongs in the log file, without updating the view
+        void writePendingToFile() {
+            if (!m_fileSink) return;
+            auto appendText = [this](const QString& text) {
+                for (QStringView line : QStringView(text).split(QLatin1Char('\n'))) {
+                    if (line.endsWith(QLatin1Char('\r'))) line.chop(1);
+                    m_fileBatch += line.toUtf8() + '\n';
+                }
+            };
+
+            for (const QString& text : std::as_const(m_pending))
+                appendText(text);
+            for (const LogLine& line : std::as_const(m_pendingLines))
+                m_fileBatch += line.text.toUtf8() + '\n';
+            if (m_sink) {
+                QVector<LogRecord> records;
+                m_sink->drain(records);
+                for (const LogRecord& record : std::as_const(records))
+                    appendText(LogSink::format(record));
+            }
+            m_pending.clear();
+            m_pendingLines.clear();
+
+            if (!m_fileBatch.isEmpty()) m_fileSink->write(m_fileBatch);
+            m_fileBatch.clear();
+        }
+
+        // split into lines and store them
+        void pushText(const QString& text, LogLevel level, const QString& source, const bool parseTags) {
+            for (QStringView line : QStringView(text).split(QLatin1Char('\n'))) {
+                if (line.endsWith(QLatin1Char('\r'))) line.chop(1);
+
+                pushLine({line.toString(), level, source, {}}, parseTags);
+            }
+        }
+
+        void pushLine(LogLine line, const bool parseTags) {
+            if (parseTags) parseLogTags(line.text, line.level, line.source);
+
+            const int length = int(line.text.size());
+            if (m_fileSink) m_fileBatch += line.text.toUtf8() + '\n';
+            const LogLevel level = line.level;
+            m_lines.push(line);
+
+            const qint64 seq = m_lines.endSequence() - 1;
+            if (length >= m_maxLineLength) {
+                m_maxLineLength = length;
+                m_maxLineSeq = seq;
+            }
+            m_levelIndex[int(level)].append(seq);
+            if (isFiltering() && isLevelVisible(level))
+                m_filtered.append(seq);
+        }
+
+        void trimIndices() {
+            const qint64 first = m_lines.firstSequence();
+            for (SequenceIndex& index : m_levelIndex)
+                index.trim(first);
+            m_filtered.trim(first);
+            trimHits();
+            if (m_maxLineSeq >= 0 && m_maxLineSeq < first) updateMaxLineLength();
+        }
+
+        // the longest line left the buffer, the horizontal range shrinks to the longest remaining one
+        void updateMaxLineLength() {
+            m_maxLineLength = 0;
+            m_maxLineSeq = -1;
+            for (qint64 seq = m_lines.firstSequence(); seq < m_lines.endSequence(); ++seq) {
+                const int length = int(m_lines.atSequence(seq).text.size());
+                if (length >= m_maxLineLength) {
+                    m_maxLineLength = length;
+                    m_maxLineSeq = seq;
+                }
+            }
+        }
+
+        void trimHits() {
+            const qint64 first = m_lines.firstSequence();
+            const int dropped = static_cast<int>(std::lower_bound(m_hits.cbegin(), m_hits.cend(), first) - m_hits.cbegin());
+            if (dropped == 0) return;
+            m_hits.remove(0, dropped);
+            m_currentHit = m_currentHit >= dropped ? m_currentHit - dropped : -1;
+        }
+
+        void rebuildFiltered() {
+            if (!isFiltering()) {
+                m_filtered.clear();
+                return;
+            }
+            QVector<qint64> merged;
+            for (int level = 0; level < LevelCount; ++level) {
+                if (!(m_levelMask & (1 << level))) continue;
+                const QVector<qint64> seqs = m_levelIndex[level].toVector();
+                QVector<qint64> result(merged.count() + seqs.count());
+                std::merge(merged.cbegin(), merged.cend(), seqs.cbegin(), seqs.cend(), result.begin());
+                merged = std::move(result);
+            }
+            m_filtered.assign(std::move(merged));
+        }
+
+        void addSearchHits(const int generation, const QVector<qint64>& hits, const bool finished) {
+            if (generation != m_searchGeneration) return;
+            m_hits.append(hits);
+            if (finished) m_searchRunning = false;
+            trimHits();
+            viewport()->update();
+            if (m_searchCallback) m_searchCallback(m_hits.count(), finished);
+        }
+
+        bool isFiltering() const {
+            return m_levelMask != AllLevels;
+        }
+
+        int rowCount() const {
+            return isFiltering() ? m_filtered.count() : m_lines.count();
+        }
+
+        qint64 rowSequence(const int row) const {
+            return isFiltering() ? m_filtered.at(row) : m_lines.firstSequence() + row;
+        }
+
+        // row of the first visible line at or after 'seq'
+        int rowOfSequence(const qint64 seq) const {
+            if (isFiltering()) return m_filtered.lowerBound(seq);
+            return static_cast<int>(qBound<qint64>(0, seq - m_lines.firstSequence(), m_lines.count()));
+        }
+
+        qint64 topSequence() const {
+            const int row = verticalScrollBar()->value();
+            return row < rowCount() ? rowSequence(row) : -1;
+        }
+
+        int lineHeight() const {
+            return fontMetrics().height();
+        }
+
+        int visibleRowCount() const {
+            return qMax(1, viewport()->height() / qMax(1, lineHeight()));
+        }
+
+        void updateScrollBars() {
+            const int rows = rowCount();
+            verticalScrollBar()->setPageStep(visibleRowCount());
+            verticalScrollBar()->setRange(0, qMax(0, rows - visibleRowCount()));
+
+            // the font is monospaced, the widest line follows from the longest one
+            const int contentWidth = m_maxLineLength * fontMetrics().horizontalAdvance(QLatin1Char('M')) + 8;
+            horizontalScrollBar()->setPageStep(viewport()->width());
+            horizontalScrollBar()->setRange(0, qMax(0, contentWidth - viewport()->width()));
+        }
+
+        qint64 sequenceAt(const QPoint& pos) const {
+            if (rowCount() == 0) return -1;
+            const int row = verticalScrollBar()->value() + pos.y() / qMax(1, lineHeight());
+            return rowSequence(qBound(0, row, rowCount() - 1));
+        }
+
+        void resizeEvent(QResizeEvent* event) override {
+            QAbstractScrollArea::resizeEvent(event);
+            const bool follow = isAtBottom();
+            updateScrollBars();
+            if (follow) scrollToBottom();
+        }
+
+        void paintEvent(QPaintEvent* event) override {
+            QPainter painter(viewport());
+            painter.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+            painter.setFont(font());
+
+            const int h = lineHeight();
+            const int ascent = fontMetrics().ascent();
+            const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('M'));
+            const int x = 4 - horizontalScrollBar()->value();
+            const int firstRow = verticalScrollBar()->value();
+            const int lastRow = qMin(rowCount(), firstRow + visibleRowCount() + 1);
+
+            const qint64 selFrom = hasSelection() ? qMin(m_selAnchor, m_selCursor) : -1;
+            const qint64 selTo = hasSelection() ? qMax(m_selAnchor, m_selCursor) : -2;
+            const bool highlightMatches = !m_searchRegex.pattern().isEmpty();
+
+            const QColor textColor = palette().color(QPalette::Text);
+            const QColor selColor = palette().color(QPalette::Highlight);
+            const QColor selTextColor = palette().color(QPalette::HighlightedText);
+            const QColor matchColor("#6b5b00");
+
+            QFont boldFont = font();
+            boldFont.setBold(true);
+
+            for (int row = firstRow; row < lastRow; ++row) {
+                const int y = (row - firstRow) * h;
+                const qint64 seq = rowSequence(row);
+                const LogLine& line = m_lines.atSequence(seq);
+
+                const bool selected = seq >= selFrom && seq <= selTo;
+                if (selected) {
+                    painter.fillRect(QRect(0, y, viewport()->width(), h), selColor);
+                }
+                if (highlightMatches) {
+                    QRegularExpressionMatchIterator it = m_searchRegex.globalMatch(line.text);
+                    while (it.hasNext()) {
+                        QRegularExpressionMatch match = it.next();
+                        if (match.capturedLength() == 0) break;
+                        painter.fillRect(QRect(x + int(match.capturedStart()) * charWidth, y,
+                                               int(match.capturedLength()) * charWidth, h), matchColor);
+                    }
+                }
+                if (line.spans.isEmpty()) {
+                    painter.setPen(selected ? selTextColor : logLevelColor(line.level, textColor));
+                    painter.drawText(x, y + ascent, line.text);
+                    continue;
+                }
+
+                for (const LogSpan& span : line.spans) {
+                    const int spanX = x + span.start * charWidth;
+                    if (span.background.isValid() && !selected) {
+                        painter.fillRect(QRect(spanX, y, span.length * charWidth, h), span.background);
+                    }
+                    if (selected) painter.setPen(selTextColor);
+                    else painter.setPen(span.foreground.isValid() ? span.foreground : logLevelColor(line.level, textColor));
+                    painter.setFont(span.bold ? boldFont : font());
+                    painter.drawText(spanX, y + ascent, line.text.mid(span.start, span.length));
+                }
+                painter.setFont(font());
+            }
+        }
+
+        void mousePressEvent(QMouseEvent* event) override {
+            if (event->button() != Qt::LeftButton) {
+                QAbstractScrollArea::mousePressEvent(event);
+                return;
+            }
+            const qint64 seq = sequenceAt(event->position().toPoint());
+            if (!(event->modifiers() & Qt::ShiftModifier) || m_selAnchor < 0)
+                m_selAnchor = seq;
+            m_selCursor = seq;
+            viewport()->update();
+        }
+
+        void mouseMoveEvent(QMouseEvent* event) override {
+            if (!(event->buttons() & Qt::LeftButton) || m_selAnchor < 0) return;
+            const QPoint pos = event->position().toPoint();
+            if (pos.y() < 0) {
+                verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+            } else if (pos.y() > viewport()->height()) {
+                verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+            }
+            m_selCursor = sequenceAt(pos);
+            viewport()->update();
+        }
+
+        void keyPressEvent(QKeyEvent* event) override {
+            if (event->matches(QKeySequence::Copy)) {
+                copySelection();
+            } else if (event->matches(QKeySequence::SelectAll)) {
+                selectAll();
+            } else if (event->matches(QKeySequence::MoveToEndOfDocument)) {
+                scrollToBottom();
+            } else if (event->matches(QKeySequence::MoveToStartOfDocument)) {
+                verticalScrollBar()->setValue(0);
+            } else {
+                QAbstractScrollArea::keyPressEvent(event);
+            }
+        }
+    };
+
+
+    /* Read-only viewer for log files of any size.
+    The file is memory mapped, never loaded, and a sparse line index (one offset every
+    IndexStride lines) is built on a worker thread; rows appear while indexing runs.
+    Only the visible lines are decoded, with their level colors and ANSI spans, and
+    of those at most MaxLineBytes each.
+
+    Example usage:
+        LogFileViewport* viewer = new LogFileViewport(this);
+        if (!viewer->open("session.log"))
+            qWarning() << viewer->errorString();
+    */
+    class LogFileViewport : public QAbstractScrollArea
+    {
+    public:
+        static constexpr int IndexStride = 64;
+        static constexpr qint64 MaxLineBytes = 4096;        // decoded per line, the rest is elided
+
+    private:
+        // the worker publishes its progress after this much time or this many bytes indexed
+        static constexpr qint64 PublishMsecs = 50;
+        static constexpr qint64 PublishBytes = 16 * 1024 * 1024;
+
+        // shared with the indexing worker
+        struct Index {
+            QMutex mutex;
+            QVector<qint64> checkpoints;     // offset of every IndexStride-th line
+            qint64 lineCount = 0;
+            bool done = false;
+            std::atomic<bool> cancel {false};
+        };
+
+        QFile m_file;
+        const char* m_data = nullptr;
+        qint64 m_size = 0;
+        std::shared_ptr<Index> m_index;
+        QFuture<void> m_indexing;
+        QTimer* m_progressTimer = nullptr;
+        QString m_error;
+
+        qint64 m_lineCount = 0;
+        qint64 m_selAnchor = -1;
+        qint64 m_selCursor = -1;
+        std::function<void(qint64 lines, bool finished)> m_indexCallback;
+
+    public:
+        explicit LogFileViewport(QWidget* parent = nullptr) : QAbstractScrollArea(parent) {
+            initUI();
+        }
+        ~LogFileViewport() override {
+            close();
+        }
+
+        void initUI() {
+            setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+            setFocusPolicy(Qt::StrongFocus);
+            viewport()->setCursor(Qt::IBeamCursor);
+
+            m_progressTimer = new QTimer(this);
+            m_progressTimer->setInterval(100);
+            connect(m_progressTimer, &QTimer::timeout, this, [this]() { syncIndex(); });
+        }
+
+        bool open(const QString& path) {
+            close();
+            m_file.setFileName(path);
+            if (!m_file.open(QIODevice::ReadOnly)) {
+                m_error = m_file.errorString();
+                return false;
+            }
+
+            m_size = m_file.size();
+            if (m_size > 0) {
+                m_data = reinterpret_cast<const char*>(m_file.map(0, m_size));
+                if (m_data == nullptr) {
+                    m_error = m_file.errorString();
+                    m_file.close();
+                    return false;
+                }
+            }
+
+            auto index = std::make_shared<Index>();
+            m_index = index;
+            const char* data = m_data;
+            const qint64 size = m_size;
+            m_indexing = QtConcurrent::run([index, data, size]() { buildIndex(*index, data, size); });
+            m_progressTimer->start();
+            syncIndex();
+            return true;
+        }
+
+        void close() {
+            if (m_index) {
+                m_index->cancel.store(true);
+                m_indexing.waitForFinished();     // the worker reads the mapping
+            }
+            m_progressTimer->stop();
+            m_index.reset();
+            if (m_data) m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+            m_data = nullptr;
+            m_size = 0;
+            m_file.close();
+            m_lineCount = 0;
+            m_selAnchor = -1;
+            m_selCursor = -1;
+            updateScrollBars();
+            viewport()->update();
+        }
+
+        bool isOpen() const { return m_file.isOpen(); }
+        QString fileName() const { return m_file.fileName(); }
+        QString errorString() const { return m_error; }
+
+        // lines indexed so far
+        qint64 lineCount() const { return m_lineCount; }
+
+        bool isIndexing() const { return m_index && !m_indexing.isFinished(); }
+
+        void setIndexCallback(std::function<void(qint64 lines, bool finished)> callback) {
+            m_indexCallback = std::move(callback);
+        }
+
+        // at most 'maxBytes' (all of it when negative) of the line, an ellipsis marks the cut
+        QString lineAt(const qint64 line, const qint64 maxBytes = MaxLineBytes) const {
+            return decodeLine(lineBytes(line), maxBytes);
+        }
+
+        void copySelection() const {
+            if (m_selAnchor < 0 || m_selCursor < 0) return;
+            const qint64 from = qMin(m_selAnchor, m_selCursor);
+            const qint64 to = qMin(qMax(m_selAnchor, m_selCursor), from + 100000);     // keep the clipboard sane
+
+            QStringList result;
+            for (qint64 line = from; line <= to && line < m_lineCount; ++line)
+                result.append(lineAt(line));
+            QGuiApplication::clipboard()->setText(result.join('\n'));
+        }
+
+    protected:
+        static QString decodeLine(QByteArrayView bytes, const qint64 maxBytes) {
+            if (maxBytes < 0 || bytes.size() <= maxBytes) return QString::fromUtf8(bytes);
+            // do not cut a UTF-8 sequence in half
+            qsizetype cut = qsizetype(maxBytes);
+            while (cut > 0 && (uchar(bytes.at(cut)) & 0xC0) == 0x80) cut --;
+            return QString::fromUtf8(bytes.first(cut)) + QChar(0x2026);
+        }
+
+        static void buildIndex(Index& index, const char* data, const qint64 size) {
+            QVector<qint64> batch;
+            qint64 lines = 0;
+            qint64 pos = 0;
+            qint64 publishedPos = 0;
+            QElapsedTimer timer;
+            timer.start();
+
+            auto publish = [&](bool done) {
+                QMutexLocker locker(&index.mutex);
+                index.checkpoints.append(batch);
+                index.lineCount = lines;
+                index.done = done;
+                batch.clear();
+                publishedPos = pos;
+                timer.restart();
+            };
+
+            while (pos < size) {
+                if (lines % IndexStride == 0) batch.append(pos);
+                const void* newline = memchr(data + pos, '\n', size_t(size - pos));
+                pos = newline ? static_cast<const char*>(newline) - data + 1 : size;
+                lines ++;
+
+                // by time for short lines, by bytes for long ones, rows show up while indexing runs
+                if (pos - publishedPos >= PublishBytes || (lines % IndexStride == 0 && timer.hasExpired(PublishMsecs))) {
+                    if (index.cancel.load(std::memory_order_relaxed)) return;
+                    publish(false);
+                }
+            }
+            publish(true);
+        }
+
+        // take over what the worker has indexed so far
+        void syncIndex() {
+            if (!m_index) return;
+            bool done = false;
+            {
+                QMutexLocker locker(&m_index->mutex);
+                m_lineCount = m_index->lineCount;
+                done = m_index->done;
+            }
+            if (done) m_progressTimer->stop();
+
+            updateScrollBars();
+            viewport()->update();
+            if (m_indexCallback) m_indexCallback(m_lineCount, done);
+        }
+
+        qint64 lineOffset(const qint64 line) const {
+            qint64 offset = 0;
+            {
+                QMutexLocker locker(&m_index->mutex);
+                offset = m_index->checkpoints.at(int(line / IndexStride));
+            }
+            for (qint64 i = line % IndexStride; i > 0 && offset < m_size; --i) {
+                const void* newline = memchr(m_data + offset, '\n', size_t(m_size - offset));
+                offset = newline ? static_cast<const char*>(newline) - m_data + 1 : m_size;
+            }
+            return offset;
+        }
+
+        // bytes of the line starting at 'offset', without the line break
+        QByteArrayView lineBytesAt(const qint64 offset) const {
+            const void* newline = memchr(m_data + offset, '\n', size_t(m_size - offset));
+            qint64 end = newline ? static_cast<const char*>(newline) - m_data : m_size;
+            if (end > offset && m_data[end - 1] == '\r') end --;
+            return QByteArrayView(m_data + offset, end - offset);
+        }
+
+        QByteArrayView lineBytes(const qint64 line) const {
+            if (line < 0 || line >= m_lineCount) return QByteArrayView();
+            return lineBytesAt(lineOffset(line));
+        }
+
+        int lineHeight() const {
+            return fontMetrics().height();
+        }
+
+        int visibleRowCount() const {
+            return qMax(1, viewport()->height() / qMax(1, lineHeight()));
+        }
+
+        // scroll bar values are int, very long files scroll in steps of several lines
+        qint64 linesPerStep() const {
+            return qMax<qint64>(1, (m_lineCount + INT_MAX - 1) / INT_MAX);
+        }
+
+        qint64 topLine() const {
+            return qint64(verticalScrollBar()->value()) * linesPerStep();
+        }
+
+        void updateScrollBars() {
+            const qint64 steps = m_lineCount / linesPerStep();
+            verticalScrollBar()->setPageStep(visibleRowCount());
+            verticalScrollBar()->setRange(0, int(qMax<qint64>(0, steps - visibleRowCount())));
+
+            // lines are not measured ahead, 1000 columns are enough for logs
+            const int contentWidth = 1000 * fontMetrics().horizontalAdvance(QLatin1Char('M'));
+            horizontalScrollBar()->setPageStep(viewport()->width());
+            horizontalScrollBar()->setRange(0, qMax(0, contentWidth - viewport()->width()));
+        }
+
+        qint64 lineAtPos(const QPoint& pos) const {
+            if (m_lineCount == 0) return -1;
+            return qBound<qint64>(0, topLine() + pos.y() / qMax(1, lineHeight()), m_lineCount - 1);
+        }
+
+        void resizeEvent(QResizeEvent* event) override {
+            QAbstractScrollArea::resizeEvent(event);
+            updateScrollBars();
+        }
+
+        void paintEvent(QPaintEvent* event) override {
+            QPainter painter(viewport());
+            painter.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+            if (m_lineCount == 0) return;
+            painter.setFont(font());
+
+            const int h = lineHeight();
+            const int ascent = fontMetrics().ascent();
+            const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('M'));
+            const int x = 4 - horizontalScrollBar()->value();
+            const qint64 first = topLine();
+            const qint64 last = qMin(m_lineCount, first + visibleRowCount() + 1);
+
+            const qint64 selFrom = m_selAnchor >= 0 ? qMin(m_selAnchor, m_selCursor) : -1;
+            const qint64 selTo = m_selAnchor >= 0 ? qMax(m_selAnchor, m_selCursor) : -2;
+            const QColor textColor = palette().color(QPalette::Text);
+
+            QFont boldFont = font();
+            boldFont.setBold(true);
+
+            qint64 offset = lineOffset(first);
+            for (qint64 row = first; row < last && offset <= m_size; ++row) {
+                const int y = int(row - first) * h;
+                const QByteArrayView bytes = lineBytesAt(offset);
+                offset = bytes.data() - m_data + bytes.size();
+                if (offset < m_size && m_data[offset] == '\r') offset ++;
+                offset ++;
+
+                LogLine line;
+                AnsiParser parser;
+                parser.parseLine(decodeLine(bytes, MaxLineBytes), line);
+                parseLogTags(line.text, line.level, line.source);
+
+                const bool selected = row >= selFrom && row <= selTo;
+                if (selected) {
+                    painter.fillRect(QRect(0, y, viewport()->width(), h), palette().color(QPalette::Highlight));
+                }
+                const QColor color = selected ? palette().color(QPalette::HighlightedText)
+                                              : logLevelColor(line.level, textColor);
+                if (line.spans.isEmpty()) {
+                    painter.setPen(color);
+                    painter.drawText(x, y + ascent, line.text);
+                    continue;
+                }
+                for (const LogSpan& span : line.spans) {
+                    const int spanX = x + span.start * charWidth;
+                    if (span.background.isValid() && !selected) {
+                        painter.fillRect(QRect(spanX, y, span.length * charWidth, h), span.background);
+                    }
+                    painter.setPen(selected || !span.foreground.isValid() ? color : span.foreground);
+                    painter.setFont(span.bold ? boldFont : font());
+                    painter.drawText(spanX, y + ascent, line.text.mid(span.start, span.length));
+                }
+                painter.setFont(font());
+            }
+        }
+
+        void mousePressEvent(QMouseEvent* event) override {
+            if (event->button() != Qt::LeftButton) {
+                QAbstractScrollArea::mousePressEvent(event);
+                return;
+            }
+            const qint64 line = lineAtPos(event->position().toPoint());
+            if (!(event->modifiers() & Qt::ShiftModifier) || m_selAnchor < 0)
+                m_selAnchor = line;
+            m_selCursor = line;
+            viewport()->update();
+        }
+
+        void mouseMoveEvent(QMouseEvent* event) override {
+            if (!(event->buttons() & Qt::LeftButton) || m_selAnchor < 0) return;
+            m_selCursor = lineAtPos(event->position().toPoint());
+            viewport()->update();
+        }
+
+        void keyPressEvent(QKeyEvent* event) override {
+            if (event->matches(QKeySequence::Copy)) {
+                copySelection();
+            } else if (event->matches(QKeySequence::MoveToEndOfDocument)) {
+                verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+            } else if (event->matches(QKeySequence::MoveToStartOfDocument)) {
+                verticalScrollBar()->setValue(0);
+            } else {
+                QAbstractScrollArea::keyPressEvent(event);
+            }
+        }
+    };
+
+
+    /* Streams the output of a QProcess into a LogViewport.
+    Output is read in large chunks, decoded incrementally (multi-byte characters may be split
+    between reads), split into lines with the unfinished line carried over to the next read,
+    and ANSI colors are turned into styled spans. Reading is capped per event loop pass,
+    so a very chatty child cannot starve the GUI.
+    The connector is a child of the process and goes away with it.
+
+    Example usage:
+        QProcess* process = general_util::getWorkProcess(this);
+        new ProcessLogConnector(process, logView->getViewport());
+        process->start(program, args);
+    */
+    class ProcessLogConnector : public QObject
+    {
+    public:
+        static constexpr qint64 ChunkSize = 256 * 1024;
+        static constexpr qint64 ReadBudget = 4 * 1024 * 1024;     // per event loop pass
+        static constexpr int MaxLineLength = 64 * 1024;
+
+    private:
+        struct Channel {
+            QStringDecoder decoder {QStringDecoder::Utf8};
+            AnsiParser parser;
+            QString partial;
+            bool readScheduled = false;
+        };
+
+        QPointer<QProcess> m_process;
+        QPointer<LogViewport> m_viewport;
+        Channel m_channels[2];
+        QByteArray m_buffer;
+        LogLevel m_errorLevel = LogLevel::Error;
+
+    public:
+        ProcessLogConnector(QProcess* process, LogViewport* viewport)
+            : QObject(process), m_process(process), m_viewport(viewport) {
+            m_buffer.resize(ChunkSize);
+
+            connect(process, &QProcess::readyReadStandardOutput, this, [this]() { readChannel(QProcess::StandardOutput); });
+            connect(process, &QProcess::readyReadStandardError, this, [this]() { readChannel(QProcess::StandardError); });
+            connect(process, &QProcess::finished, this, [this]() { finish(); });
+        }
+
+        // level given to stderr lines without a level tag, when the channels are separate
+        void setErrorLevel(const LogLevel level) { m_errorLevel = level; }
+
+        /* Read what is left and emit the unfinished last lines.
+        */
+        void finish() {
+            readChannel(QProcess::StandardOutput, -1);
+            readChannel(QProcess::StandardError, -1);
+
+            for (int ch = 0; ch < 2; ++ch) {
+                Channel& channel = m_channels[ch];
+                if (channel.partial.isEmpty()) continue;
+
+                QVector<LogLine> lines;
+                lines.append(makeLine(channel, channel.partial, ch));
+                channel.partial.clear();
+                if (m_viewport) m_viewport->appendLogLines(std::move(lines));
+            }
+        }
+
+    private:
+        void readChannel(const QProcess::ProcessChannel ch, qint64 budget = ReadBudget) {
+            if (!m_process) return;
+            const QProcess::ProcessChannel previous = m_process->readChannel();
+            m_process->setReadChannel(ch);
+
+            Channel& channel = m_channels[ch];
+            QVector<LogLine> lines;
+            while (m_process->bytesAvailable() > 0 && budget != 0) {
+                const qint64 n = m_process->read(m_buffer.data(), ChunkSize);
+                if (n <= 0) break;
+                if (budget > 0) budget = qMax<qint64>(0, budget - n);
+
+                channel.partial.append(QString(channel.decoder.decode(QByteArrayView(m_buffer.constData(), n))));
+                splitLines(channel, int(ch), lines);
+            }
+
+            const bool more = m_process->bytesAvailable() > 0;
+            m_process->setReadChannel(previous);
+
+            if (!lines.isEmpty() && m_viewport) m_viewport->appendLogLines(std::move(lines));
+
+            // let the event loop breathe, then continue where we stopped
+            if (more && !channel.readScheduled) {
+                channel.readScheduled = true;
+                QTimer::singleShot(0, this, [this, ch]() {
+                    m_channels[ch].readScheduled = false;
+                    readChannel(ch);
+                });
+            }
+        }
+
+        void splitLines(Channel& channel, const int ch, QVector<LogLine>& lines) {
+            QStringView text(channel.partial);
+            qsizetype start = 0;
+            qsizetype end = text.indexOf(QLatin1Char('\n'));
+            while (end >= 0) {
+                QStringView line = text.mid(start, end - start);
+                if (line.endsWith(QLatin1Char('\r'))) line.chop(1);
+                lines.append(makeLine(channel, line, ch));
+                start = end + 1;
+                end = text.indexOf(QLatin1Char('\n'), start);
+            }
+            channel.partial.remove(0, start);
+
+            // a child that never ends its line should not grow the carry forever
+            if (channel.partial.size() >= MaxLineLength) {
+                lines.append(makeLine(channel, channel.partial, ch));
+                channel.partial.clear();
+            }
+        }
+
+        LogLine makeLine(Channel& channel, QStringView raw, const int ch) {
+            LogLine line;
+            line.level = ch == QProcess::StandardError ? m_errorLevel : LogLevel::Info;
+            channel.parser.parseLine(raw, line);
+            return line;
+        }
+    };
+
+
+    /* Log panel: level filters, regex search with next/previous and a virtualized viewport.
+
+    Example usage:
+        LogView* log = new LogView(this);
+        log->attachSink();                  // drain LogSink::instance()
+        log->append("[WARNING] [render] missing texture");
+        log->setLevelVisible(LogLevel::Debug, false);
+        log->search("texture.*missing");
+        log->attachProcess(process);        // colored, line-buffered process output
+        log->setLogFile("logs/session.log");  // rotating copy on disk
+        log->openFile("logs/old.log");        // memory mapped, back with closeFile()
+    */
+    class LogView : public QWidget
+    {
+    private:
+        LogViewport* m_logField = nullptr;
+        QLineEdit* m_searchEdit = nullptr;
+        QLabel* m_hitsLabel = nullptr;
+        QLabel* m_titleLabel = nullptr;
+        LogFileViewport* m_fileField = nullptr;
+        QTimer* m_searchTimer = nullptr;
+        QToolButton* m_levelBtns[LogViewport::LevelCount] = {};
+
+    public:
+        explicit LogView(QWidget* parent = nullptr) : QWidget(parent) {
+            initUI();
+        }
+        ~LogView() = default;
+
+        void initUI() {
+            // controls
+            QPushButton* clearBtn = new QPushButton(this);
+            clearBtn->setIcon(this->style()->standardPixmap(QStyle::SP_TrashIcon));
+            clearBtn->setFixedSize(QSize(20,20));
+            clearBtn->setToolTip("Clear Log Field");
+
+            const char* levelLabels[] = {"D", "I", "W", "E"};
+            for (int level = 0; level <= int(LogLevel::Error); ++level) {
+                QToolButton* btn = new QToolButton(this);
+                btn->setText(levelLabels[level]);
+                btn->setCheckable(true);
+                btn->setChecked(true);
+                btn->setFixedSize(QSize(20,20));
+                btn->setToolTip("Show " + logLevelName(LogLevel(level)).toLower() + " lines");
+                m_levelBtns[level] = btn;
+            }
+
+            m_searchEdit = new QLineEdit(this);
+            m_searchEdit->setPlaceholderText("Search (regex)");
+            m_searchEdit->setClearButtonEnabled(true);
+
+            QToolButton* prevBtn = new QToolButton(this);
+            prevBtn->setIcon(this->style()->standardIcon(QStyle::SP_ArrowUp));
+            prevBtn->setFixedSize(QSize(20,20));
+            prevBtn->setToolTip("Previous Match");
+
+            QToolButton* nextBtn = new QToolButton(this);
+            nextBtn->setIcon(this->style()->standardIcon(QStyle::SP_ArrowDown));
+            nextBtn->setFixedSize(QSize(20,20));
+            nextBtn->setToolTip("Next Match");
+
+            m_hitsLabel = new QLabel(this);
+            m_hitsLabel->setMinimumWidth(60);
+
+            m_searchTimer = new QTimer(this);
+            m_searchTimer->setSingleShot(true);
+            m_searchTimer->setInterval(200);
+
+            m_logField = new LogViewport(this);
+
+            // layouts
+            QVBoxLayout* lay = new QVBoxLayout(this);
+            lay->setSpacing(2);
+            lay->setContentsMargins(1,1,1,1);
+            setLayout(lay);
+
+            QHBoxLayout* topLay = new QHBoxLayout();
+            lay->addLayout(topLay);
+
+            m_titleLabel = new QLabel(" Log ", this);
+            topLay->addWidget(m_titleLabel);
+            for (int level = 0; level <= int(LogLevel::Error); ++level)
+                topLay->addWidget(m_levelBtns[level]);
+            topLay->addWidget(m_searchEdit, 1);
+            topLay->addWidget(prevBtn);
+            topLay->addWidget(nextBtn);
+            topLay->addWidget(m_hitsLabel);
+            topLay->addWidget(clearBtn);
+
+            lay->addWidget(m_logField);
+
+            // connections
+            connect(clearBtn, &QPushButton::clicked, m_logField, &LogViewport::clear);
+            connect(prevBtn, &QToolButton::clicked, m_logField, &LogViewport::findPrevious);
+            connect(nextBtn, &QToolButton::clicked, m_logField, [this]() { m_logField->findNext(); });
+            connect(m_searchEdit, &QLineEdit::returnPressed, m_logField, [this]() {
+                if (m_searchTimer->isActive()) runSearch();
+                m_logField->findNext();
+            });
+            connect(m_searchEdit, &QLineEdit::textChanged, m_searchTimer, [this]() { m_searchTimer->start(); });
+            connect(m_searchTimer, &QTimer::timeout, this, [this]() { runSearch(); });
+
+            for (int level = 0; level <= int(LogLevel::Error); ++level) {
+                connect(m_levelBtns[level], &QToolButton::toggled, m_logField, [this, level](bool checked) {
+                    m_logField->setLevelVisible(LogLevel(level), checked);
+                    // fatal lines follow the error toggle
+                    if (LogLevel(level) == LogLevel::Error) m_logField->setLevelVisible(LogLevel::Fatal, checked);
+                });
+            }
+
+            m_logField->setSearchCallback([this](int hits, bool finished) {
+                if (m_searchEdit->text().isEmpty()) {
+                    m_hitsLabel->clear();
+                    return;
+                }
+                const int current = m_logField->currentSearchHit();
+                QString text = current >= 0 ? QString("%1/%2").arg(current + 1).arg(hits) : QString::number(hits);
+                m_hitsLabel->setText(finished ? text : text + "...");
+            });
+        }
+
+        LogViewport* getViewport() const {
+            return m_logField;
+        }
+
+        // kept for source compatibility, returns the same LogViewport
+        [[deprecated("LogView no longer wraps a QTextEdit, use getViewport()")]]
+        LogViewport* getField() const {
+            return m_logField;
+        }
+
+        void append(const QString& text) {
+            m_logField->append(text);
+        }
+
+        void attachSink(LogSink* sink = &LogSink::instance()) { m_logField->attachSink(sink); }
+        void detachSink() { m_logField->detachSink(); }
+
+        // stream the output of 'process' into this view, see ProcessLogConnector
+        ProcessLogConnector* attachProcess(QProcess* process) {
+            return new ProcessLogConnector(process, m_logField);
+        }
+
+        void setLogFile(const QString& path, const qint64 maxBytes = 64 * 1024 * 1024, const int maxFiles = 5) {
+            m_logField->setLogFile(path, maxBytes, maxFiles);
+        }
+
+        int maximumLineCount() const { return m_logField->maximumLineCount(); }
+        void setMaximumLineCount(const int count) { m_logField->setMaximumLineCount(count); }
+
+        bool isLevelVisible(const LogLevel level) const { return m_logField->isLevelVisible(level); }
+        // the error button covers fatal lines too, fatal alone has no button of its own
+        void setLevelVisible(const LogLevel level, const bool visible) {
+            if (level == LogLevel::Fatal) {
+                m_logField->setLevelVisible(level, visible);
+                return;
+            }
+            QToolButton* btn = m_levelBtns[int(level)];
+            if (btn->isChecked() != visible) btn->setChecked(visible);
+            else m_logField->setLevelVisible(level, visible);
+        }
+
+        /* Show a log file from disk instead of the live log, see LogFileViewport.
+        */
+        bool openFile(const QString& path) {
+            if (m_fileField == nullptr) {
+                m_fileField = new LogFileViewport(this);
+                layout()->addWidget(m_fileField);
+            }
+            if (!m_fileField->open(path)) return false;
+
+            m_logField->hide();
+            m_fileField->show();
+            m_titleLabel->setText(" " + QFileInfo(path).fileName() + " ");
+            m_titleLabel->setToolTip(path);
+            return true;
+        }
+
+        // back to the live log
+        void closeFile() {
+            if (m_fileField == nullptr) return;
+            m_fileField->close();
+            m_fileField->hide();
+            m_logField->show();
+            m_titleLabel->setText(" Log ");
+            m_titleLabel->setToolTip(QString());
+        }
+
+        LogFileViewport* getFileField() const {
+            return m_fileField;
+        }
+
+        void search(const QString& pattern) {
+            m_searchEdit->setText(pattern);
+            runSearch();
+        }
+
+    private:
+        void runSearch() {
+            m_searchTimer->stop();
+            const bool valid = m_logField->startSearch(m_searchEdit->text());
+            QPalette pal = palette();
+            if (!valid) pal.setColor(QPalette::Text, QColor("#ff5050"));
+            m_searchEdit->setPalette(pal);
+            if (!valid) m_hitsLabel->setText("invalid");
+        }
+
+    };
+
+}   // namespace utilWidgets
@@ -0,0 +1,506 @@
+#pragma once
+#include <atomic>
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <QLabel>
+#include <QFrame>
+#include <QScreen>
+#include <QObject>
+#include <QThread>
+#include <QPointer>
+#include <QDateTime>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include "utils.h"
+
+
+namespace utilWidgets {
+
+    /* Small non-modal popup used by NotificationCenter, stacked at the bottom right of the host window.
+    */
+    class NotificationToast : public QFrame
+    {
+    private:
+        QLabel* m_titleLabel = nullptr;
+        QLabel* m_msgLabel = nullptr;
+        QLabel* m_countLabel = nullptr;
+        QTimer* m_hideTimer = nullptr;
+        std::function<void(NotificationToast*)> m_onHidden;
+
+    public:
+        explicit NotificationToast(QWidget* parent = nullptr) : QFrame(parent) {
+            initUI();
+        }
+        ~NotificationToast() override = default;
+
+        void initUI() {
+            setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
+            setAttribute(Qt::WA_ShowWithoutActivating);
+            setAttribute(Qt::WA_DeleteOnClose);
+            setFrameShape(QFrame::StyledPanel);
+            setAutoFillBackground(true);
+            setPalette(darkModePalete());
+            setFixedWidth(320);
+
+            // controls
+            m_titleLabel = new QLabel(this);
+            QFont font = m_titleLabel->font();
+            font.setBold(true);
+            m_titleLabel->setFont(font);
+
+            m_countLabel = new QLabel(this);
+            m_countLabel->setHidden(true);
+
+            QPushButton* closeBtn = new QPushButton("x", this);
+            closeBtn->setFixedSize(QSize(20, 20));
+            closeBtn->setFlat(true);
+
+            m_msgLabel = new QLabel(this);
+            m_msgLabel->setWordWrap(true);
+
+            m_hideTimer = new QTimer(this);
+            m_hideTimer->setSingleShot(true);
+
+            // layouts
+            QVBoxLayout* lay = new QVBoxLayout(this);
+            lay->setSpacing(4);
+            lay->setContentsMargins(8, 6, 8, 8);
+            setLayout(lay);
+
+            QHBoxLayout* topLay = new QHBoxLayout();
+            topLay->addWidget(m_titleLabel, 1);
+            topLay->addWidget(m_countLabel);
+            topLay->addWidget(closeBtn);
+            lay->addLayout(topLay);
+            lay->addWidget(m_msgLabel);
+
+            // signals
+            connect(closeBtn, &QPushButton::clicked, this, &QWidget::close);
+            connect(m_hideTimer, &QTimer::timeout, this, &QWidget::close);
+        }
+
+        void setContent(const QString& title, const QString& msg, const QColor& color) {
+            m_titleLabel->setText(title);
+            m_msgLabel->setText(msg);
+
+            QPalette palette = m_titleLabel->palette();
+            palette.setColor(QPalette::WindowText, color);
+            m_titleLabel->setPalette(palette);
+        }
+
+        void setCount(int count) {
+            m_countLabel->setText(QString("x%1").arg(count));
+            m_countLabel->setHidden(count <= 1);
+        }
+
+        // (re)start the auto hide countdown
+        void touch(int timeOut) {
+            if (timeOut > 0) m_hideTimer->start(timeOut);
+        }
+
+        void setHiddenCallback(std::function<void(NotificationToast*)> callback) {
+            m_onHidden = std::move(callback);
+        }
+
+    protected:
+        void closeEvent(QCloseEvent* e) override {
+            QFrame::closeEvent(e);
+            if (m_onHidden) m_onHidden(this);
+        }
+    };
+
+}   // namespace utilWidgets
+
+
+/* Non-modal replacement for stacks of dialog_limited() warnings.
+Notifications can be posted from any thread. Identical notifications are merged into one
+entry with a counter, and the GUI is updated at most once per 'flush interval',
+so a storm of 1,000 identical warnings shows a single toast counting up.
+
+Example usage:
+    NotificationCenter::instance()->setHostWidget(mainWindow);
+    ...
+    // from any thread
+    NotificationCenter::instance()->post(NotificationCenter::Warning, "Export", "Missing texture: foo.png");
+
+    // history panel
+    auto* history = new NotificationHistoryView(this);
+*/
+class NotificationCenter : public QObject
+{
+Q_OBJECT
+
+signals:
+    void historyChanged();
+
+public:
+    enum Level {
+        Info = 0,
+        Warning,
+        Error
+    };
+    Q_ENUM(Level)
+
+    struct Entry {
+        Level level = Info;
+        QString title;
+        QString message;
+        int count = 0;
+        QDateTime first;
+        QDateTime last;
+    };
+
+private:
+    struct Pending {
+        Level level = Info;
+        QString title;
+        QString message;
+        int count = 0;
+    };
+
+    // producer side, any thread
+    QMutex m_pendingMutex;
+    QHash<QString, Pending> m_pending;
+    QStringList m_pendingOrder;
+    std::atomic<bool> m_flushScheduled{false};
+    std::atomic<bool> m_attachScheduled{false};
+
+    // GUI side
+    QVector<Entry> m_history;
+    QHash<QString, int> m_historyIndex;
+    QHash<QString, QPointer<utilWidgets::NotificationToast>> m_toasts;
+    QList<QPointer<utilWidgets::NotificationToast>> m_toastOrder;
+    QPointer<utilWidgets::NotificationToast> m_overflowToast;
+    int m_overflowCount = 0;
+    QPointer<QWidget> m_host;
+    QTimer* m_flushTimer = nullptr;
+    QElapsedTimer m_sinceFlush;
+
+    int m_flushInterval = 250;
+    int m_toastTimeOut = 6000;
+    int m_maxToasts = 4;
+    int m_maxHistory = 500;
+
+    explicit NotificationCenter(QObject* parent = nullptr) : QObject(parent) {}
+
+public:
+    ~NotificationCenter() override = default;
+
+    static NotificationCenter* instance() {
+        // created on first use from any thread, but always lives in the GUI thread
+        static NotificationCenter* center = []() {
+            auto* c = new NotificationCenter();
+            QCoreApplication* app = QCoreApplication::instance();
+            // before the application exists there is no GUI thread yet, stay unbound until
+            // the GUI thread asks for the instance and pulls it over
+            if (!app) c->moveToThread(nullptr);
+            else if (c->thread() != app->thread()) c->moveToThread(app->thread());
+            return c;
+        }();
+        if (center->thread() == nullptr) center->requestAttach();
+        return center;
+    }
+
+    static QString levelName(Level level) {
+        switch (level) {
+        case Warning: return "Warning";
+        case Error: return "Error";
+        default: return "Info";
+        }
+    }
+
+    static QColor levelColor(Level level) {
+        switch (level) {
+        case Warning: return QColor("#FF8000");
+        case Error: return QColor("#ff5050");
+        default: return QColor("#8fbcff");
+        }
+    }
+
+    // GUI thread only
+    void setHostWidget(QWidget* host) { m_host = host; }
+    void setFlushInterval(int msec) { m_flushInterval = qMax(0, msec); }
+    void setToastTimeOut(int msec) { m_toastTimeOut = msec; }
+    void setMaxToasts(int count) { m_maxToasts = qMax(1, count); }
+    void setMaxHistory(int count) { m_maxHistory = qMax(1, count); }
+
+    const QVector<Entry>& history() const { return m_history; }
+
+    void clearHistory() {
+        m_history.clear();
+        m_historyIndex.clear();
+        emit historyChanged();
+    }
+
+    /* Thread-safe. Duplicates are merged before they reach the GUI thread.
+    */
+    void post(Level level, const QString& title, const QString& message) {
+        const QString key = makeKey(level, title, message);
+        {
+            QMutexLocker locker(&m_pendingMutex);
+            auto it = m_pending.find(key);
+            if (it == m_pending.end()) {
+                m_pending.insert(key, {level, title, message, 1});
+                m_pendingOrder.append(key);
+            } else {
+                it->count ++;
+            }
+        }
+
+        // not bound to the GUI thread yet, attachToApplication() schedules the flush
+        if (thread() == nullptr) {
+            requestAttach();
+            return;
+        }
+        if (!m_flushScheduled.exchange(true)) {
+            QMetaObject::invokeMethod(this, &NotificationCenter::scheduleFlush, Qt::QueuedConnection);
+        }
+    }
+
+private:
+    /* Bind to the GUI thread once the application exists, from whichever thread notices first.
+    Worker threads hand the job to the application object, which runs it on the GUI thread.
+    */
+    void requestAttach() {
+        QCoreApplication* app = QCoreApplication::instance();
+        if (!app) return;
+        if (QThread::currentThread() == app->thread()) {
+            attachToApplication();
+        } else if (!m_attachScheduled.exchange(true)) {
+            QMetaObject::invokeMethod(app, [this]() { attachToApplication(); }, Qt::QueuedConnection);
+        }
+    }
+
+    // objects without a thread can only be pulled into the current one, so only the GUI thread does it
+    void attachToApplication() {
+        QCoreApplication* app = QCoreApplication::instance();
+        if (!app || QThread::currentThread() != app->thread() || thread() != nullptr) return;
+        moveToThread(app->thread());
+
+        bool hasPending = false;
+        {
+            QMutexLocker locker(&m_pendingMutex);
+            hasPending = !m_pendingOrder.isEmpty();
+        }
+        if (hasPending && !m_flushScheduled.exchange(true)) {
+            QMetaObject::invokeMethod(this, &NotificationCenter::scheduleFlush, Qt::QueuedConnection);
+        }
+    }
+
+    static QString makeKey(Level level, const QString& title, const QString& message) {
+        return QString::number(level) + QChar(0x1f) + title + QChar(0x1f) + message;
+    }
+
+    void scheduleFlush() {
+        if (m_flushTimer == nullptr) {
+            m_flushTimer = new QTimer(this);
+            m_flushTimer->setSingleShot(true);
+            connect(m_flushTimer, &QTimer::timeout, this, &NotificationCenter::flush);
+        }
+        if (m_flushTimer->isActive()) return;
+
+        // rate limit: at most one GUI update per flush interval
+        qint64 wait = 0;
+        if (m_sinceFlush.isValid())
+            wait = qMax<qint64>(0, m_flushInterval - m_sinceFlush.elapsed());
+        m_flushTimer->start(static_cast<int>(wait));
+    }
+
+    void flush() {
+        QHash<QString, Pending> pending;
+        QStringList order;
+        {
+            QMutexLocker locker(&m_pendingMutex);
+            pending.swap(m_pending);
+            order.swap(m_pendingOrder);
+            m_flushScheduled = false;
+        }
+        m_sinceFlush.restart();
+        if (order.isEmpty()) return;
+
+        const QDateTime now = QDateTime::currentDateTime();
+        for (const QString& key : order) {
+            const Pending& p = pending[key];
+
+            int index = m_historyIndex.value(key, -1);
+            if (index < 0) {
+                trimHistory();
+                index = m_history.count();
+                m_history.append({p.level, p.title, p.message, 0, now, now});
+                m_historyIndex.insert(key, index);
+            }
+            Entry& entry = m_history[index];
+            entry.count += p.count;
+            entry.last = now;
+
+            showToast(key, entry);
+        }
+
+        emit historyChanged();
+    }
+
+    void trimHistory() {
+        if (m_history.count() < m_maxHistory) return;
+
+        const int drop = m_history.count() - m_maxHistory + 1;
+        m_history.remove(0, drop);
+        m_historyIndex.clear();
+        for (int i = 0; i < m_history.count(); ++i) {
+            const Entry& e = m_history.at(i);
+            m_historyIndex.insert(makeKey(e.level, e.title, e.message), i);
+        }
+    }
+
+    void showToast(const QString& key, const Entry& entry) {
+        utilWidgets::NotificationToast* toast = m_toasts.value(key);
+        if (toast == nullptr) {
+            if (visibleToastCount() >= m_maxToasts) {
+                // too many distinct notifications at once, fold the rest into one summary
+                m_overflowCount ++;
+                toast = m_overflowToast;
+                if (toast == nullptr) {
+                    toast = createToast();
+                    m_overflowToast = toast;
+                }
+                toast->setContent("Notifications",
+                                  QString("%1 more notification(s), see the history.").arg(m_overflowCount),
+                                  levelColor(Info));
+                toast->touch(m_toastTimeOut);
+                relayoutToasts();
+                return;
+            }
+            toast = createToast();
+            m_toasts.insert(key, toast);
+        }
+
+        toast->setContent(QString("%1 - %2").arg(levelName(entry.level), entry.title),
+                          entry.message, levelColor(entry.level));
+        toast->setCount(entry.count);
+        toast->touch(m_toastTimeOut);
+        relayoutToasts();
+    }
+
+    utilWidgets::NotificationToast* createToast() {
+        auto* toast = new utilWidgets::NotificationToast(m_host ? m_host->window() : nullptr);
+        toast->setHiddenCallback([this](utilWidgets::NotificationToast* t) {
+            if (t == m_overflowToast) m_overflowCount = 0;
+            for (auto it = m_toasts.begin(); it != m_toasts.end(); ++it) {
+                if (it.value() == t) {
+                    m_toasts.erase(it);
+                    break;
+                }
+            }
+            m_toastOrder.removeAll(t);
+            QTimer::singleShot(0, this, &NotificationCenter::relayoutToasts);
+        });
+        m_toastOrder.append(toast);
+        return toast;
+    }
+
+    int visibleToastCount() const {
+        int count = 0;
+        for (const auto& t : m_toastOrder) {
+            if (t && t != m_overflowToast) count ++;
+        }
+        return count;
+    }
+
+    void relayoutToasts() {
+        QRect area;
+        if (m_host) {
+            QWidget* window = m_host->window();
+            area = QRect(window->mapToGlobal(QPoint(0, 0)), window->size());
+        } else if (QScreen* screen = QGuiApplication::primaryScreen()) {
+            area = screen->availableGeometry();
+        }
+
+        int bottom = area.bottom() - 12;
+        for (const auto& t : m_toastOrder) {
+            if (!t) continue;
+            t->adjustSize();
+            t->move(area.right() - t->width() - 12, bottom - t->height());
+            bottom -= t->height() + 6;
+            if (t->isHidden()) t->show();
+        }
+    }
+};
+
+
+/* History panel for NotificationCenter, one row per distinct notification.
+*/
+class NotificationHistoryView : public QWidget
+{
+Q_OBJECT
+
+private:
+    QTreeWidget* m_tree = nullptr;
+
+public:
+    explicit NotificationHistoryView(QWidget* parent = nullptr) : QWidget(parent) {
+        initUI();
+        refresh();
+    }
+    ~NotificationHistoryView() override = default;
+
+    void initUI() {
+        // controls
+        QPushButton* clearBtn = new QPushButton(this);
+        clearBtn->setIcon(this->style()->standardPixmap(QStyle::SP_TrashIcon));
+        clearBtn->setFixedSize(QSize(20,20));
+        clearBtn->setToolTip("Clear History");
+
+        m_tree = new QTreeWidget(this);
+        m_tree->setRootIsDecorated(false);
+        m_tree->setUniformRowHeights(true);
+        m_tree->setHeaderLabels({"Time", "Level", "Title", "Message", "Count"});
+        m_tree->header()->setStretchLastSection(false);
+        m_tree->header()->setSectionResizeMode(3, QHeaderView::Stretch);
+
+        // layouts
+        QVBoxLayout* lay = new QVBoxLayout(this);
+        lay->setSpacing(2);
+        lay->setContentsMargins(1,1,1,1);
+        setLayout(lay);
+
+        QHBoxLayout* topLay = new QHBoxLayout();
+        lay->addLayout(topLay);
+        topLay->addWidget(new QLabel(" Notifications ", this));
+        topLay->addWidget(clearBtn);
+
+        lay->addWidget(m_tree);
+
+        // signals
+        NotificationCenter* center = NotificationCenter::instance();
+        connect(center, &NotificationCenter::historyChanged, this, &NotificationHistoryView::refresh);
+        connect(clearBtn, &QPushButton::clicked, center, &NotificationCenter::clearHistory);
+    }
+
+    void refresh() {
+        const QVector<NotificationCenter::Entry>& history = NotificationCenter::instance()->history();
+
+        m_tree->setUpdatesEnabled(false);
+        // newest first; existing rows are reused
+        while (m_tree->topLevelItemCount() > history.count())
+            delete m_tree->takeTopLevelItem(m_tree->topLevelItemCount() - 1);
+        while (m_tree->topLevelItemCount() < history.count())
+            m_tree->addTopLevelItem(new QTreeWidgetItem());
+
+        for (int i = 0; i < history.count(); ++i) {
+            const NotificationCenter::Entry& e = history.at(history.count() - 1 - i);
+            QTreeWidgetItem* item = m_tree->topLevelItem(i);
+            item->setText(0, e.last.toString("hh:mm:ss"));
+            item->setText(1, NotificationCenter::levelName(e.level));
+            item->setForeground(1, NotificationCenter::levelColor(e.level));
+            item->setText(2, e.title);
+            item->setText(3, e.message);
+            item->setText(4, QString::number(e.count));
+        }
+        m_tree->setUpdatesEnabled(true);
+    }
+};
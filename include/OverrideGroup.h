@@ -0,0 +1,354 @@
+#pragma once
+#include <QHash>
+#include <QObject>
+#include <QVector>
+#include <QPointer>
+#include <QBitArray>
+#include <QByteArray>
+#include <QDataStream>
+#include "utilWidgetsBases.h"
+
+
+struct OverridePresetEntry
+{
+    QString name;
+    QVariant value;
+    bool override = false;
+
+    bool operator==(const OverridePresetEntry& other) const {
+        return override == other.override && name == other.name && value == other.value;
+    }
+    bool operator!=(const OverridePresetEntry& other) const { return !(*this == other); }
+};
+
+
+/* Name/value/override snapshot of an OverrideGroup.
+Entries follow the field order of the group they were captured from.
+
+Example usage:
+    OverridePreset low = group->capture();
+    ...
+    OverridePreset high = group->capture();
+
+    // later, switching from 'low' to 'high' only touches the fields that differ
+    group->applyPreset(high, OverridePreset::diff(low, high));
+
+    QByteArray bytes = high.toByteArray();
+    OverridePreset restored = OverridePreset::fromByteArray(bytes);
+*/
+class OverridePreset
+{
+public:
+    QVector<OverridePresetEntry> entries;
+
+    int count() const { return entries.count(); }
+    bool isEmpty() const { return entries.isEmpty(); }
+
+    int indexOf(const QString& name) const {
+        for (int i = 0; i < entries.count(); ++i) {
+            if (entries.at(i).name == name) return i;
+        }
+        return -1;
+    }
+
+    /* Indices of the entries in 'to' that differ from 'from'.
+    Entries are matched by position, falling back to the name when the layouts differ.
+    */
+    static QVector<int> diff(const OverridePreset& from, const OverridePreset& to) {
+        QVector<int> result;
+        QHash<QString, int> fromByName;
+        bool sameLayout = from.count() == to.count();
+
+        for (int i = 0; i < to.count(); ++i) {
+            const OverridePresetEntry& entry = to.entries.at(i);
+            if (sameLayout && from.entries.at(i).name == entry.name) {
+                if (from.entries.at(i) != entry) result.append(i);
+                continue;
+            }
+
+            if (fromByName.isEmpty()) {
+                fromByName.reserve(from.count());
+                for (int j = 0; j < from.count(); ++j)
+                    fromByName.insert(from.entries.at(j).name, j);
+            }
+            sameLayout = false;
+
+            const int j = fromByName.value(entry.name, -1);
+            if (j < 0 || from.entries.at(j) != entry) result.append(i);
+        }
+        return result;
+    }
+
+    QByteArray toByteArray() const {
+        QByteArray bytes;
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << quint32(0x4F565250) << quint8(1) << qint32(entries.count());
+        for (const OverridePresetEntry& entry : entries) {
+            out << entry.name << entry.value << entry.override;
+        }
+        return bytes;
+    }
+
+    static OverridePreset fromByteArray(const QByteArray& bytes, bool* ok = nullptr) {
+        OverridePreset preset;
+        QDataStream in(bytes);
+        in.setVersion(QDataStream::Qt_6_0);
+
+        quint32 magic = 0;
+        quint8 version = 0;
+        qint32 count = 0;
+        in >> magic >> version >> count;
+
+        bool valid = in.status() == QDataStream::Ok && magic == 0x4F565250 && version == 1 && count >= 0;
+        if (valid) {
+            // no reserve(count), the count comes from the blob and a corrupt one must not allocate gigabytes
+            for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                OverridePresetEntry entry;
+                in >> entry.name >> entry.value >> entry.override;
+                preset.entries.append(entry);
+            }
+            valid = in.status() == QDataStream::Ok;
+        }
+
+        if (ok) *ok = valid;
+        return valid ? preset : OverridePreset();
+    }
+};
+
+
+/* Controller for a set of override fields.
+Keeps the override state of every field in a bitset and reports changes as one
+aggregated overridesChanged() per edit, so bulk operations trigger a single downstream update.
+
+Example usage:
+    OverrideGroup* group = new OverrideGroup(this);
+    for (auto* field : fields)
+        group->addField(field);
+    connect(group, &OverrideGroup::overridesChanged, this, [](const QBitArray& changed) { ... });
+
+    group->resetAll();                       // one overridesChanged()
+    {
+        OverrideGroup::Transaction edit(group);
+        group->setOverride(3, true);
+        group->applyMask(presetMask);
+    }                                        // one overridesChanged() here
+*/
+class OverrideGroup : public QObject
+{
+Q_OBJECT
+
+signals:
+    // bits set in 'changed' are the fields whose override state flipped during the edit
+    void overridesChanged(const QBitArray& changed);
+
+private:
+    QVector<QPointer<OverrideFieldWidgetBase>> m_fields;
+    QHash<const OverrideFieldWidgetBase*, int> m_indexByField;
+    QBitArray m_state;
+    QBitArray m_changed;
+    int m_editDepth = 0;
+
+public:
+    /* RAII helper, everything done while it is alive is reported as one change.
+    */
+    class Transaction
+    {
+    private:
+        OverrideGroup* m_group = nullptr;
+
+    public:
+        explicit Transaction(OverrideGroup* group) : m_group(group) {
+            if (m_group) m_group->beginEdit();
+        }
+        ~Transaction() {
+            if (m_group) m_group->endEdit();
+        }
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+    };
+
+    explicit OverrideGroup(QObject* parent = nullptr) : QObject(parent) {}
+    ~OverrideGroup() override = default;
+
+    int addField(OverrideFieldWidgetBase* field) {
+        if (field == nullptr) return -1;
+        if (m_indexByField.contains(field)) return m_indexByField.value(field);
+
+        const int index = m_fields.count();
+        m_fields.append(field);
+        m_indexByField.insert(field, index);
+        m_state.resize(index + 1);
+        m_changed.resize(index + 1);
+        m_state.setBit(index, field->isOverride());
+
+        connect(field, &OverrideFieldWidgetBase::overrideChanged, this, [this, index](bool override) {
+            on_fieldOverrideChanged(index, override);
+        });
+        connect(field, &QObject::destroyed, this, [this](QObject* obj) {
+            m_indexByField.remove(static_cast<OverrideFieldWidgetBase*>(obj));
+        });
+        return index;
+    }
+
+    template <typename Container>
+    void addFields(const Container& fields) {
+        for (auto* field : fields)
+            addField(field);
+    }
+
+    void clear() {
+        for (const auto& field : m_fields) {
+            if (field) disconnect(field, nullptr, this, nullptr);
+        }
+        m_fields.clear();
+        m_indexByField.clear();
+        m_state.clear();
+        m_changed.clear();
+    }
+
+    int count() const { return m_fields.count(); }
+
+    OverrideFieldWidgetBase* field(int index) const {
+        return (index >= 0 && index < m_fields.count()) ? m_fields.at(index).data() : nullptr;
+    }
+
+    int indexOf(const OverrideFieldWidgetBase* field) const {
+        return m_indexByField.value(field, -1);
+    }
+
+    const QBitArray& state() const { return m_state; }
+
+    bool isOverride(int index) const {
+        return index >= 0 && index < m_state.size() && m_state.testBit(index);
+    }
+
+    void setOverride(int index, bool override) {
+        OverrideFieldWidgetBase* f = field(index);
+        if (f == nullptr || m_state.testBit(index) == override) return;
+
+        beginEdit();
+        f->setOverride(override);
+        endEdit();
+    }
+
+    void setAll(bool override) {
+        beginEdit();
+        for (int i = 0; i < m_fields.count(); ++i) {
+            if (m_fields.at(i) && m_state.testBit(i) != override)
+                m_fields.at(i)->setOverride(override);
+        }
+        endEdit();
+    }
+
+    void resetAll() {
+        setAll(false);
+    }
+
+    /* Set the override state of every field from 'mask', fields past the mask size are reset.
+    */
+    void applyMask(const QBitArray& mask) {
+        beginEdit();
+        for (int i = 0; i < m_fields.count(); ++i) {
+            const bool override = i < mask.size() && mask.testBit(i);
+            if (m_fields.at(i) && m_state.testBit(i) != override)
+                m_fields.at(i)->setOverride(override);
+        }
+        endEdit();
+    }
+
+    void beginEdit() {
+        m_editDepth ++;
+    }
+
+    void endEdit() {
+        if (m_editDepth <= 0) return;
+        if (--m_editDepth > 0 || m_changed.count(true) == 0) return;
+
+        QBitArray changed = m_changed;
+        m_changed.fill(false);
+        emit overridesChanged(changed);
+    }
+
+    bool isEditing() const { return m_editDepth > 0; }
+
+    /* Snapshot name, value and override state of every field.
+    */
+    OverridePreset capture() const {
+        OverridePreset preset;
+        preset.entries.reserve(m_fields.count());
+        for (const auto& f : m_fields) {
+            OverridePresetEntry entry;
+            if (f) {
+                entry.name = f->getName();
+                entry.value = f->getFieldValue();
+                entry.override = f->isOverride();
+            }
+            preset.entries.append(entry);
+        }
+        return preset;
+    }
+
+    /* Write the given preset entries back to the fields, as one edit.
+    With 'rows' (e.g. from OverridePreset::diff) only those entries are applied,
+    so switching presets costs proportionally to the number of changed fields.
+    */
+    void applyPreset(const OverridePreset& preset, const QVector<int>& rows) {
+        QHash<QString, OverrideFieldWidgetBase*> byName;
+        beginEdit();
+        for (int row : rows) {
+            if (row < 0 || row >= preset.count()) continue;
+            applyPresetEntry(row, preset.entries.at(row), byName);
+        }
+        endEdit();
+    }
+
+    void applyPreset(const OverridePreset& preset) {
+        QHash<QString, OverrideFieldWidgetBase*> byName;
+        beginEdit();
+        for (int row = 0; row < preset.count(); ++row) {
+            applyPresetEntry(row, preset.entries.at(row), byName);
+        }
+        endEdit();
+    }
+
+private:
+    // 'byName' is built on the first entry whose row does not match, once per apply
+    void applyPresetEntry(int row, const OverridePresetEntry& entry, QHash<QString, OverrideFieldWidgetBase*>& byName) {
+        OverrideFieldWidgetBase* f = field(row);
+        if (f == nullptr || f->getName() != entry.name) {
+            if (byName.isEmpty()) byName = fieldsByName();
+            f = byName.value(entry.name, nullptr);
+            if (f == nullptr) return;
+        }
+
+        if (entry.value.isValid() && f->getFieldValue() != entry.value)
+            f->setFieldValue(entry.value);
+        f->setOverride(entry.override);
+    }
+
+    // the first field wins when names repeat
+    QHash<QString, OverrideFieldWidgetBase*> fieldsByName() const {
+        QHash<QString, OverrideFieldWidgetBase*> result;
+        result.reserve(m_fields.count());
+        for (const auto& f : m_fields) {
+            if (f && !result.contains(f->getName())) result.insert(f->getName(), f.data());
+        }
+        return result;
+    }
+
+    void on_fieldOverrideChanged(int index, bool override) {
+        if (index >= m_state.size() || m_state.testBit(index) == override) return;
+
+        m_state.setBit(index, override);
+        // flipping back inside the same edit cancels the change
+        m_changed.toggleBit(index);
+
+        // changes made directly on the field (e.g. its context menu) are reported right away
+        if (m_editDepth == 0) {
+            m_editDepth ++;
+            endEdit();
+        }
+    }
+
+};
@@ -0,0 +1,282 @@
+#pragma once
+#include <QSet>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QObject>
+#include "utils.h"
+
+#if defined(_WIN32)
+#include <tlhelp32.h>
+#include <QWinEventNotifier>
+#elif defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <QSocketNotifier>
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+
+namespace general_util {
+
+    /* PIDs of every descendant of 'pid', breadth first (children before grandchildren).
+    Reads /proc on Linux and a toolhelp snapshot on Windows; empty elsewhere.
+    */
+    inline QList<qint64> descendantPIDs(const qint64 pid) {
+        QMultiHash<qint64, qint64> children;
+
+#if defined(_WIN32)
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) return {};
+        PROCESSENTRY32W entry;
+        entry.dwSize = sizeof(entry);
+        for (BOOL ok = Process32FirstW(snapshot, &entry); ok; ok = Process32NextW(snapshot, &entry)) {
+            if (entry.th32ProcessID != entry.th32ParentProcessID)
+                children.insert(entry.th32ParentProcessID, entry.th32ProcessID);
+        }
+        CloseHandle(snapshot);
+#elif defined(__linux__)
+        const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString& name : entries) {
+            bool isPid = false;
+            const qint64 child = name.toLongLong(&isPid);
+            if (!isPid) continue;
+
+            QFile stat("/proc/" + name + "/stat");
+            if (!stat.open(QIODevice::ReadOnly)) continue;
+            // "pid (comm) state ppid ...", comm may contain spaces and parentheses
+            const QByteArray line = stat.readLine();
+            const int end = line.lastIndexOf(')');
+            if (end < 0) continue;
+            const QList<QByteArray> fields = line.mid(end + 2).split(' ');
+            if (fields.size() > 1) children.insert(fields.at(1).toLongLong(), child);
+        }
+#endif
+
+        QList<qint64> result;
+        QList<qint64> level = {pid};
+        while (!level.isEmpty()) {
+            QList<qint64> next;
+            for (qint64 parent : level) {
+                const QList<qint64> direct = children.values(parent);
+                for (qint64 child : direct) {
+                    if (child == pid || result.contains(child)) continue;
+                    result.append(child);
+                    next.append(child);
+                }
+            }
+            level = next;
+        }
+        return result;
+    }
+
+    /* Ask 'pid' to exit (SIGTERM), or kill it with 'force' (SIGKILL).
+    Windows has no graceful equivalent for arbitrary processes, both terminate it.
+    */
+    inline bool signalPID(const qint64 pid, const bool force) {
+#ifdef _WIN32
+        Q_UNUSED(force);
+        return killPID(pid);
+#else
+        if (pid <= 0) return false;
+        return ::kill(static_cast<pid_t>(pid), force ? SIGKILL : SIGTERM) == 0;
+#endif
+    }
+
+}   // namespace general_util
+
+
+/* Watches many PIDs and reports each exit once, without polling.
+On Linux every PID gets a pidfd registered with a single epoll instance, which one
+QSocketNotifier listens to, so hundreds of watched processes cost nothing while they run.
+Kernels without pidfd (< 5.3) fall back to checking the PIDs every 500 ms.
+On Windows each process handle is waited on through a QWinEventNotifier.
+
+Example usage:
+    ProcessMonitor* monitor = new ProcessMonitor(this);
+    connect(monitor, &ProcessMonitor::processExited, this, [](qint64 pid) { ... });
+    monitor->watch(process->processId());
+    ...
+    monitor->terminateTree(pid, 3000);      // SIGTERM the whole tree, SIGKILL survivors after 3 s
+*/
+class ProcessMonitor : public QObject
+{
+Q_OBJECT
+
+signals:
+    void processExited(qint64 pid);
+
+private:
+#if defined(_WIN32)
+    QHash<qint64, QWinEventNotifier*> m_notifiers;
+#elif defined(__linux__)
+    int m_epollFd = -1;
+    QSocketNotifier* m_notifier = nullptr;
+    QHash<qint64, int> m_pidfds;
+#endif
+    QSet<qint64> m_polled;
+    QTimer* m_pollTimer = nullptr;
+
+public:
+    explicit ProcessMonitor(QObject* parent = nullptr) : QObject(parent) {
+        m_pollTimer = new QTimer(this);
+        m_pollTimer->setInterval(500);
+        connect(m_pollTimer, &QTimer::timeout, this, &ProcessMonitor::on_pollTimeout);
+
+#if defined(__linux__)
+        m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epollFd >= 0) {
+            m_notifier = new QSocketNotifier(m_epollFd, QSocketNotifier::Read, this);
+            connect(m_notifier, &QSocketNotifier::activated, this, &ProcessMonitor::on_epollReady);
+        }
+#endif
+    }
+
+    ~ProcessMonitor() override {
+#if defined(_WIN32)
+        for (QWinEventNotifier* notifier : std::as_const(m_notifiers)) {
+            const HANDLE handle = notifier->handle();
+            notifier->setEnabled(false);
+            delete notifier;
+            CloseHandle(handle);
+        }
+#elif defined(__linux__)
+        for (int fd : std::as_const(m_pidfds))
+            ::close(fd);
+        if (m_epollFd >= 0) ::close(m_epollFd);
+#endif
+    }
+
+    /* Start watching 'pid'. Returns false when it is not running (no signal is emitted then).
+    */
+    bool watch(const qint64 pid) {
+        if (isWatching(pid)) return true;
+        if (!general_util::isRunningPID(pid)) return false;
+
+#if defined(_WIN32)
+        HANDLE handle = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+        if (handle) {
+            QWinEventNotifier* notifier = new QWinEventNotifier(handle, this);
+            connect(notifier, &QWinEventNotifier::activated, this, [this, pid]() { on_exited(pid); });
+            m_notifiers.insert(pid, notifier);
+            return true;
+        }
+#elif defined(__linux__)
+        const int fd = m_epollFd >= 0 ? int(syscall(SYS_pidfd_open, pid_t(pid), 0)) : -1;
+        if (fd >= 0) {
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = quint64(pid);
+            if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) == 0) {
+                m_pidfds.insert(pid, fd);
+                return true;
+            }
+            ::close(fd);
+        }
+#endif
+
+        m_polled.insert(pid);
+        if (!m_pollTimer->isActive()) m_pollTimer->start();
+        return true;
+    }
+
+    void unwatch(const qint64 pid) {
+#if defined(_WIN32)
+        if (QWinEventNotifier* notifier = m_notifiers.take(pid)) {
+            // the notifier may be emitting right now; the handle is closed once it is gone,
+            // never while it can still wait on it
+            const HANDLE handle = notifier->handle();
+            notifier->setEnabled(false);
+            connect(notifier, &QObject::destroyed, [handle]() { CloseHandle(handle); });
+            notifier->deleteLater();
+        }
+#elif defined(__linux__)
+        if (m_pidfds.contains(pid)) {
+            const int fd = m_pidfds.take(pid);
+            epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+        }
+#endif
+        m_polled.remove(pid);
+        if (m_polled.isEmpty()) m_pollTimer->stop();
+    }
+
+    bool isWatching(const qint64 pid) const {
+#if defined(_WIN32)
+        if (m_notifiers.contains(pid)) return true;
+#elif defined(__linux__)
+        if (m_pidfds.contains(pid)) return true;
+#endif
+        return m_polled.contains(pid);
+    }
+
+    int count() const {
+#if defined(_WIN32)
+        return m_notifiers.count() + m_polled.count();
+#elif defined(__linux__)
+        return m_pidfds.count() + m_polled.count();
+#else
+        return m_polled.count();
+#endif
+    }
+
+    /* Terminate 'pid' and all its descendants: SIGTERM first, SIGKILL for whatever is
+    still alive after 'graceMs', including children spawned meanwhile. Every member of the
+    tree is watched, so processExited() follows for each of them.
+    */
+    void terminateTree(const qint64 pid, const int graceMs = 3000) {
+        QList<qint64> tree = general_util::descendantPIDs(pid);
+        tree.prepend(pid);
+
+        for (qint64 member : std::as_const(tree)) {
+            if (watch(member)) general_util::signalPID(member, false);
+        }
+        QTimer::singleShot(qMax(0, graceMs), this, [this, tree]() {
+            // only PIDs that were not reported as exited, a reported PID may have been reused
+            QList<qint64> survivors;
+            for (qint64 member : tree) {
+                if (isWatching(member)) survivors.append(member);
+            }
+            // survivors may have forked during the grace period, snapshot their trees again
+            QList<qint64> targets = survivors;
+            for (qint64 member : std::as_const(survivors)) {
+                const QList<qint64> descendants = general_util::descendantPIDs(member);
+                for (qint64 descendant : descendants) {
+                    if (!targets.contains(descendant)) targets.append(descendant);
+                }
+            }
+            for (qint64 member : std::as_const(targets)) {
+                if (watch(member)) general_util::signalPID(member, true);
+            }
+        });
+    }
+
+private:
+    void on_exited(const qint64 pid) {
+        if (!isWatching(pid)) return;
+        unwatch(pid);
+        emit processExited(pid);
+    }
+
+    void on_epollReady() {
+#if defined(__linux__)
+        epoll_event events[64];
+        int n = 0;
+        do {
+            n = epoll_wait(m_epollFd, events, 64, 0);
+            for (int i = 0; i < n; ++i)
+                on_exited(qint64(events[i].data.u64));
+        } while (n == 64);
+#endif
+    }
+
+    void on_pollTimeout() {
+        const QList<qint64> pids = m_polled.values();
+        for (qint64 pid : pids) {
+            if (!general_util::isRunningPID(pid)) on_exited(pid);
+        }
+    }
+
+};
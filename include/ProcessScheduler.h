@@ -0,0 +1,321 @@
+#pragma once
+#include <map>
+#include <QHash>
+#include <QTimer>
+#include <QObject>
+#include <QThread>
+#include <QProcess>
+#include <QElapsedTimer>
+#include "utils.h"
+
+
+/* One process to run through a ProcessScheduler.
+*/
+struct ProcessJob
+{
+    QString program;
+    QStringList arguments;
+    QString workingDirectory;
+    QStringList pyPaths;                // appended to PYTHONPATH of the environment below
+    QProcessEnvironment environment;    // used instead of baseEnvironment() when not empty
+    QByteArray input;                   // written to stdin, which is then closed
+
+    int priority = 0;                   // higher runs first, FIFO within a priority
+    int timeoutMs = 0;                  // 0 - no timeout
+    int maxRetries = 0;                 // extra attempts after a crash, timeout or start failure
+    bool retryOnExitCode = false;       // also retry on a non-zero exit code
+    QProcess::ProcessChannelMode channelMode = QProcess::MergedChannels;
+};
+
+
+struct ProcessJobResult
+{
+    enum Status {
+        Finished = 0,       // exited on its own, see exitCode
+        FailedToStart,
+        Crashed,
+        TimedOut,
+        Cancelled
+    };
+
+    qint64 id = -1;
+    Status status = Finished;
+    int exitCode = -1;
+    int attempts = 0;
+    qint64 elapsedMs = 0;               // of the last attempt
+    QByteArray output;                  // stdout, or both channels when merged (empty if read by someone else)
+    QByteArray errorOutput;
+    QString errorString;
+
+    bool ok() const { return status == Finished && exitCode == 0; }
+};
+
+
+/* Bounded pool of worker processes.
+Jobs are queued by priority and at most maxConcurrent() of them run at once
+(QThread::idealThreadCount() by default), so a batch of hundreds of scripts keeps
+every core busy without oversubscribing the machine. Every job ends with exactly one
+jobFinished(), whether it succeeded, failed, timed out or was cancelled.
+
+Example usage:
+    ProcessScheduler* scheduler = new ProcessScheduler(this);
+    connect(scheduler, &ProcessScheduler::jobFinished, this, [](const ProcessJobResult& result) {
+        qDebug() << result.id << result.exitCode << result.output;
+    });
+    connect(scheduler, &ProcessScheduler::jobStarted, this, [this](qint64 id, QProcess* process) {
+        logView->attachProcess(process);    // optional live output
+    });
+
+    ProcessJob job;
+    job.program = "python";
+    job.arguments = {script};
+    job.pyPaths = {general_util::getPythonScriptPath()};
+    job.timeoutMs = 60000;
+    job.maxRetries = 1;
+    qint64 id = scheduler->submit(job);
+    ...
+    scheduler->cancel(id);
+*/
+class ProcessScheduler : public QObject
+{
+Q_OBJECT
+
+signals:
+    void jobStarted(qint64 id, QProcess* process);
+    void jobFinished(const ProcessJobResult& result);
+    // the queue is empty and nothing is running
+    void idle();
+
+private:
+    struct Running {
+        ProcessJob job;
+        QProcess* process = nullptr;
+        QTimer* timeout = nullptr;
+        QElapsedTimer elapsed;
+        int attempts = 0;
+        bool timedOut = false;
+        bool cancelled = false;
+        bool done = false;
+    };
+
+    struct Pending {
+        qint64 id = -1;
+        ProcessJob job;
+        int attempts = 0;
+    };
+
+    // key: (-priority, order), so the map starts with the next job to run
+    using QueueKey = std::pair<int, qint64>;
+    std::map<QueueKey, Pending> m_queue;
+    QHash<qint64, QueueKey> m_queueKeys;
+    QHash<qint64, Running*> m_running;
+
+    qint64 m_nextId = 1;
+    qint64 m_nextOrder = 0;
+    int m_maxConcurrent = QThread::idealThreadCount();
+    bool m_dispatchScheduled = false;
+
+public:
+    explicit ProcessScheduler(QObject* parent = nullptr) : QObject(parent) {}
+
+    // running processes are killed, their jobs are not reported
+    ~ProcessScheduler() override {
+        for (Running* run : std::as_const(m_running)) {
+            run->done = true;
+            disconnect(run->process, nullptr, this, nullptr);
+            run->process->kill();
+            run->process->waitForFinished(1000);
+            delete run;
+        }
+    }
+
+    int maxConcurrent() const { return m_maxConcurrent; }
+    void setMaxConcurrent(const int count) {
+        m_maxConcurrent = qMax(1, count);
+        scheduleDispatch();
+    }
+
+    int pendingCount() const { return int(m_queue.size()); }
+    int runningCount() const { return m_running.count(); }
+    bool isIdle() const { return m_queue.empty() && m_running.isEmpty(); }
+
+    bool contains(const qint64 id) const {
+        return m_queueKeys.contains(id) || m_running.contains(id);
+    }
+
+    // process of a running job, nullptr otherwise
+    QProcess* process(const qint64 id) const {
+        Running* run = m_running.value(id, nullptr);
+        return run ? run->process : nullptr;
+    }
+
+    /* Queue 'job', returns its id. Jobs submitted in one go are started in priority order.
+    */
+    qint64 submit(const ProcessJob& job) {
+        const qint64 id = m_nextId ++;
+        enqueue({id, job, 0}, false);
+        return id;
+    }
+
+    QList<qint64> submit(const QList<ProcessJob>& jobs) {
+        QList<qint64> ids;
+        ids.reserve(jobs.count());
+        for (const ProcessJob& job : jobs)
+            ids.append(submit(job));
+        return ids;
+    }
+
+    /* Cancel a queued or running job, it is reported with the Cancelled status.
+    */
+    bool cancel(const qint64 id) {
+        if (m_queueKeys.contains(id)) {
+            auto it = m_queue.find(m_queueKeys.take(id));
+            ProcessJobResult result;
+            result.id = id;
+            result.status = ProcessJobResult::Cancelled;
+            result.attempts = it->second.attempts;
+            m_queue.erase(it);
+            emit jobFinished(result);
+            checkIdle();
+            return true;
+        }
+
+        Running* run = m_running.value(id, nullptr);
+        if (run == nullptr) return false;
+        run->cancelled = true;
+        run->process->kill();
+        return true;
+    }
+
+    void cancelAll() {
+        const QList<qint64> queued = m_queueKeys.keys();
+        for (qint64 id : queued)
+            cancel(id);
+        const QList<qint64> running = m_running.keys();
+        for (qint64 id : running)
+            cancel(id);
+    }
+
+private:
+    void enqueue(Pending&& pending, const bool retry) {
+        // a retry goes ahead of the jobs with the same priority
+        const qint64 order = retry ? -(m_nextOrder ++) - 1 : m_nextOrder ++;
+        const QueueKey key(-pending.job.priority, order);
+        m_queueKeys.insert(pending.id, key);
+        m_queue.emplace(key, std::move(pending));
+        scheduleDispatch();
+    }
+
+    void scheduleDispatch() {
+        if (m_dispatchScheduled) return;
+        m_dispatchScheduled = true;
+        QTimer::singleShot(0, this, [this]() {
+            m_dispatchScheduled = false;
+            dispatch();
+        });
+    }
+
+    void dispatch() {
+        while (m_running.count() < m_maxConcurrent && !m_queue.empty()) {
+            auto it = m_queue.begin();
+            Pending pending = std::move(it->second);
+            m_queue.erase(it);
+            m_queueKeys.remove(pending.id);
+            start(std::move(pending));
+        }
+    }
+
+    void start(Pending&& pending) {
+        const qint64 id = pending.id;
+        Running* run = new Running();
+        run->job = std::move(pending.job);
+        run->attempts = pending.attempts + 1;
+
+        const ProcessJob& job = run->job;
+        QProcess* proc = new QProcess(this);
+        // a custom environment still gets pyPaths; without one the shared cached environment is used
+        proc->setProcessEnvironment(job.environment.isEmpty()
+            ? general_util::pythonEnvironment(job.pyPaths)
+            : general_util::EnvironmentBuilder(job.environment).appendPath("PYTHONPATH", job.pyPaths).build());
+        proc->setProcessChannelMode(job.channelMode);
+        if (!job.workingDirectory.isEmpty()) proc->setWorkingDirectory(job.workingDirectory);
+        run->process = proc;
+
+        if (job.timeoutMs > 0) {
+            run->timeout = new QTimer(proc);
+            run->timeout->setSingleShot(true);
+            run->timeout->setInterval(job.timeoutMs);
+            connect(run->timeout, &QTimer::timeout, this, [run]() {
+                run->timedOut = true;
+                run->process->kill();
+            });
+        }
+
+        connect(proc, &QProcess::started, this, [this, id, run]() {
+            if (!run->job.input.isEmpty()) run->process->write(run->job.input);
+            run->process->closeWriteChannel();
+            if (run->timeout) run->timeout->start();
+            emit jobStarted(id, run->process);
+        });
+        connect(proc, &QProcess::finished, this, [this, id, run](int exitCode, QProcess::ExitStatus status) {
+            ProcessJobResult::Status result = ProcessJobResult::Finished;
+            if (run->cancelled) result = ProcessJobResult::Cancelled;
+            else if (run->timedOut) result = ProcessJobResult::TimedOut;
+            else if (status == QProcess::CrashExit) result = ProcessJobResult::Crashed;
+            on_processDone(id, run, result, exitCode);
+        });
+        connect(proc, &QProcess::errorOccurred, this, [this, id, run](QProcess::ProcessError error) {
+            // every other error is followed by finished()
+            if (error == QProcess::FailedToStart)
+                on_processDone(id, run, ProcessJobResult::FailedToStart, -1);
+        });
+
+        m_running.insert(id, run);
+        run->elapsed.start();
+        proc->start(job.program, job.arguments);
+    }
+
+    void on_processDone(const qint64 id, Running* run, const ProcessJobResult::Status status, const int exitCode) {
+        if (run->done) return;
+        run->done = true;
+        m_running.remove(id);
+
+        if (run->timeout) run->timeout->stop();
+        QProcess* proc = run->process;
+        disconnect(proc, nullptr, this, nullptr);
+        proc->deleteLater();
+
+        const bool failed = status == ProcessJobResult::FailedToStart
+                            || status == ProcessJobResult::Crashed
+                            || status == ProcessJobResult::TimedOut
+                            || (status == ProcessJobResult::Finished && exitCode != 0 && run->job.retryOnExitCode);
+
+        if (failed && run->attempts <= run->job.maxRetries) {
+            enqueue({id, std::move(run->job), run->attempts}, true);
+            delete run;
+            return;
+        }
+
+        ProcessJobResult result;
+        result.id = id;
+        result.status = status;
+        result.exitCode = exitCode;
+        result.attempts = run->attempts;
+        result.elapsedMs = run->elapsed.elapsed();
+        result.errorString = status == ProcessJobResult::Finished ? QString() : proc->errorString();
+        if (status != ProcessJobResult::FailedToStart) {
+            result.output = proc->readAllStandardOutput();
+            result.errorOutput = proc->readAllStandardError();
+        }
+        delete run;
+
+        scheduleDispatch();
+        emit jobFinished(result);
+        checkIdle();
+    }
+
+    void checkIdle() {
+        if (isIdle()) emit idle();
+    }
+
+};
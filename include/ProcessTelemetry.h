@@ -0,0 +1,515 @@
+#pragma once
+#include <QSet>
+#include <QHash>
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QDateTime>
+#include <QTableView>
+#include <QHeaderView>
+#include <QFutureWatcher>
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include "utils.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+
+/* Resource usage of one process at one point in time.
+*/
+struct ProcessSample
+{
+    qint64 timestamp = 0;       // msecs since epoch
+    double cpuPercent = 0.0;    // since the previous sample, 100 = one core
+    qint64 cpuTimeMs = 0;       // user + system, total
+    qint64 rssBytes = 0;
+    qint64 readBytes = 0;       // storage I/O, total
+    qint64 writeBytes = 0;
+    int threads = 0;
+};
+
+
+struct ProcessStats
+{
+    qint64 pid = 0;
+    qint64 parentPid = 0;
+    qint64 rootPid = 0;         // the tracked process this one belongs to
+    QString name;
+    bool running = true;
+    utilWidgets::RingBuffer<ProcessSample> history {60};
+
+    ProcessSample latest() const {
+        return history.isEmpty() ? ProcessSample() : history.at(history.count() - 1);
+    }
+};
+
+
+/* Samples CPU, memory, I/O and thread counts of tracked processes and their descendants.
+A pass reads /proc/<pid>/stat once per process (which also yields the parent PIDs used to
+find descendants) plus /proc/<pid>/io for the processes of interest, on a worker thread,
+so sampling a few hundred processes every second stays in the low milliseconds.
+Linux only; elsewhere tracking works but no samples are produced.
+
+Example usage:
+    ProcessTelemetry* telemetry = new ProcessTelemetry(this);
+    telemetry->track(process->processId());
+    connect(telemetry, &ProcessTelemetry::sampled, this, [telemetry]() {
+        for (const ProcessStats& stats : telemetry->processes())
+            qDebug() << stats.pid << stats.latest().cpuPercent << stats.latest().rssBytes;
+    });
+
+    ProcessTelemetryView* view = new ProcessTelemetryView(telemetry, this);
+*/
+class ProcessTelemetry : public QObject
+{
+Q_OBJECT
+
+signals:
+    // a sampling pass has been merged, processes() is up to date
+    void sampled();
+    void processExited(qint64 pid);
+
+public:
+    struct RawSample {
+        qint64 pid = 0;
+        qint64 parentPid = 0;
+        QString name;
+        qint64 cpuTicks = 0;
+        qint64 rssPages = 0;
+        qint64 readBytes = 0;
+        qint64 writeBytes = 0;
+        int threads = 0;
+    };
+
+private:
+    QHash<qint64, ProcessStats> m_stats;
+    QHash<qint64, qint64> m_lastTicks;
+    QSet<qint64> m_roots;
+    QTimer* m_timer = nullptr;
+    QFutureWatcher<QHash<qint64, RawSample>>* m_watcher = nullptr;
+    qint64 m_lastPass = 0;
+    int m_historyLength = 60;
+    bool m_descendants = true;
+
+public:
+    explicit ProcessTelemetry(QObject* parent = nullptr) : QObject(parent) {
+        m_timer = new QTimer(this);
+        m_timer->setInterval(1000);
+        connect(m_timer, &QTimer::timeout, this, &ProcessTelemetry::sampleNow);
+
+        m_watcher = new QFutureWatcher<QHash<qint64, RawSample>>(this);
+        connect(m_watcher, &QFutureWatcherBase::finished, this, [this]() { merge(m_watcher->result()); });
+    }
+
+    ~ProcessTelemetry() override {
+        m_watcher->waitForFinished();
+    }
+
+    int interval() const { return m_timer->interval(); }
+    void setInterval(const int ms) { m_timer->setInterval(qMax(100, ms)); }
+
+    int historyLength() const { return m_historyLength; }
+    void setHistoryLength(const int count) {
+        m_historyLength = qMax(1, count);
+        for (ProcessStats& stats : m_stats)
+            stats.history.setCapacity(m_historyLength);
+    }
+
+    bool includesDescendants() const { return m_descendants; }
+    void setIncludeDescendants(const bool enabled) { m_descendants = enabled; }
+
+    /* Track 'pid' (and its descendants), sampling starts with the first tracked process.
+    */
+    void track(const qint64 pid) {
+        if (pid <= 0 || m_roots.contains(pid)) return;
+        m_roots.insert(pid);
+        if (!m_timer->isActive()) m_timer->start();
+        sampleNow();
+    }
+
+    void untrack(const qint64 pid) {
+        m_roots.remove(pid);
+        for (auto it = m_stats.begin(); it != m_stats.end();) {
+            if (it->rootPid == pid) {
+                m_lastTicks.remove(it.key());
+                it = m_stats.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (m_roots.isEmpty()) m_timer->stop();
+    }
+
+    QList<qint64> trackedPids() const { return m_roots.values(); }
+
+    bool contains(const qint64 pid) const { return m_stats.contains(pid); }
+    ProcessStats stats(const qint64 pid) const { return m_stats.value(pid); }
+
+    // tracked processes and their descendants
+    QList<ProcessStats> processes() const { return m_stats.values(); }
+
+    /* Latest sample of a tracked process summed over its whole tree.
+    */
+    ProcessSample treeTotals(const qint64 rootPid) const {
+        ProcessSample total;
+        for (const ProcessStats& stats : m_stats) {
+            if (stats.rootPid != rootPid || !stats.running) continue;
+            const ProcessSample s = stats.latest();
+            total.timestamp = qMax(total.timestamp, s.timestamp);
+            total.cpuPercent += s.cpuPercent;
+            total.cpuTimeMs += s.cpuTimeMs;
+            total.rssBytes += s.rssBytes;
+            total.readBytes += s.readBytes;
+            total.writeBytes += s.writeBytes;
+            total.threads += s.threads;
+        }
+        return total;
+    }
+
+    // start a pass now, skipped while the previous one is still running
+    void sampleNow() {
+        if (m_roots.isEmpty() || m_watcher->isRunning()) return;
+        const QSet<qint64> roots = m_roots;
+        const bool descendants = m_descendants;
+        m_watcher->setFuture(QtConcurrent::run([roots, descendants]() { return collect(roots, descendants); }));
+    }
+
+    /* One pass over /proc: the tracked processes and, with 'descendants', everything below them.
+    */
+    static QHash<qint64, RawSample> collect(const QSet<qint64>& roots, const bool descendants) {
+        QHash<qint64, RawSample> result;
+#ifdef __linux__
+        QHash<qint64, RawSample> all;
+        if (descendants) {
+            const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            all.reserve(entries.count());
+            for (const QString& name : entries) {
+                bool isPid = false;
+                const qint64 pid = name.toLongLong(&isPid);
+                RawSample sample;
+                if (isPid && readStat(pid, sample)) all.insert(pid, sample);
+            }
+        } else {
+            for (qint64 pid : roots) {
+                RawSample sample;
+                if (readStat(pid, sample)) all.insert(pid, sample);
+            }
+        }
+
+        // keep the roots and, walking up the parent chain, their descendants
+        for (auto it = all.begin(); it != all.end(); ++it) {
+            qint64 pid = it.key();
+            for (int depth = 0; depth < 64 && pid > 1; ++depth) {
+                if (roots.contains(pid)) {
+                    result.insert(it.key(), it.value());
+                    break;
+                }
+                if (!descendants) break;
+                auto parent = all.constFind(pid);
+                if (parent == all.constEnd()) break;
+                pid = parent->parentPid;
+            }
+        }
+        for (RawSample& sample : result)
+            readIo(sample);
+#else
+        Q_UNUSED(roots);
+        Q_UNUSED(descendants);
+#endif
+        return result;
+    }
+
+private:
+#ifdef __linux__
+    static int readSmallFile(const char* path, char* buffer, const int size) {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return -1;
+        const ssize_t n = ::read(fd, buffer, size_t(size - 1));
+        ::close(fd);
+        if (n < 0) return -1;
+        buffer[n] = '\0';
+        return int(n);
+    }
+
+    static bool readStat(const qint64 pid, RawSample& sample) {
+        char path[64];
+        char buffer[1024];
+        qsnprintf(path, sizeof(path), "/proc/%lld/stat", static_cast<long long>(pid));
+        const int n = readSmallFile(path, buffer, sizeof(buffer));
+        if (n <= 0) return false;
+
+        // "pid (comm) state ppid ... utime(14) stime(15) ... num_threads(20) ... rss(24)"
+        const QByteArray line = QByteArray::fromRawData(buffer, n);
+        const int open = line.indexOf('(');
+        const int close = line.lastIndexOf(')');
+        if (open < 0 || close < open) return false;
+
+        const QList<QByteArray> fields = line.mid(close + 2).split(' ');
+        if (fields.size() < 22) return false;
+
+        sample.pid = pid;
+        sample.name = QString::fromUtf8(line.mid(open + 1, close - open - 1));
+        sample.parentPid = fields.at(1).toLongLong();
+        sample.cpuTicks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+        sample.threads = fields.at(17).toInt();
+        sample.rssPages = fields.at(21).toLongLong();
+        return true;
+    }
+
+    static void readIo(RawSample& sample) {
+        char path[64];
+        char buffer[512];
+        qsnprintf(path, sizeof(path), "/proc/%lld/io", static_cast<long long>(sample.pid));
+        const int n = readSmallFile(path, buffer, sizeof(buffer));
+        if (n <= 0) return;
+
+        const QList<QByteArray> lines = QByteArray::fromRawData(buffer, n).split('\n');
+        for (const QByteArray& line : lines) {
+            if (line.startsWith("read_bytes:")) sample.readBytes = line.mid(11).trimmed().toLongLong();
+            else if (line.startsWith("write_bytes:")) sample.writeBytes = line.mid(12).trimmed().toLongLong();
+        }
+    }
+#endif
+
+    void merge(const QHash<qint64, RawSample>& raw) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        const double elapsedSec = m_lastPass > 0 ? (now - m_lastPass) / 1000.0 : 0.0;
+        m_lastPass = now;
+
+#ifdef __linux__
+        static const long ticksPerSec = sysconf(_SC_CLK_TCK);
+        static const long pageSize = sysconf(_SC_PAGESIZE);
+#else
+        const long ticksPerSec = 100;
+        const long pageSize = 4096;
+#endif
+
+        for (auto it = raw.constBegin(); it != raw.constEnd(); ++it) {
+            const RawSample& r = it.value();
+            // untracked while the pass was running
+            const qint64 root = rootOf(r.pid, raw);
+            if (!m_roots.contains(root)) continue;
+
+            auto statsIt = m_stats.find(r.pid);
+            if (statsIt == m_stats.end()) {
+                ProcessStats stats;
+                stats.pid = r.pid;
+                stats.history.setCapacity(m_historyLength);
+                statsIt = m_stats.insert(r.pid, stats);
+            }
+            ProcessStats& stats = statsIt.value();
+            stats.parentPid = r.parentPid;
+            stats.rootPid = root;
+            stats.name = r.name;
+            stats.running = true;
+
+            ProcessSample sample;
+            sample.timestamp = now;
+            sample.cpuTimeMs = r.cpuTicks * 1000 / qMax(1L, ticksPerSec);
+            sample.rssBytes = r.rssPages * pageSize;
+            sample.readBytes = r.readBytes;
+            sample.writeBytes = r.writeBytes;
+            sample.threads = r.threads;
+            if (m_lastTicks.contains(r.pid) && elapsedSec > 0.0) {
+                const qint64 delta = r.cpuTicks - m_lastTicks.value(r.pid);
+                sample.cpuPercent = 100.0 * delta / (elapsedSec * qMax(1L, ticksPerSec));
+            }
+            m_lastTicks.insert(r.pid, r.cpuTicks);
+            stats.history.push(sample);
+        }
+
+        // tracked processes stay listed after they exit, descendants are dropped
+        for (auto it = m_stats.begin(); it != m_stats.end();) {
+            if (raw.contains(it.key())) {
+                ++it;
+                continue;
+            }
+            const qint64 pid = it.key();
+            const bool wasRunning = it->running;
+            m_lastTicks.remove(pid);
+            if (m_roots.contains(pid)) {
+                it->running = false;
+                ++it;
+            } else {
+                it = m_stats.erase(it);
+            }
+            if (wasRunning) emit processExited(pid);
+        }
+        emit sampled();
+    }
+
+    qint64 rootOf(qint64 pid, const QHash<qint64, RawSample>& raw) const {
+        for (int depth = 0; depth < 64; ++depth) {
+            if (m_roots.contains(pid)) return pid;
+            auto it = raw.constFind(pid);
+            if (it == raw.constEnd()) break;
+            pid = it->parentPid;
+        }
+        return pid;
+    }
+
+};
+
+
+namespace utilWidgets {
+
+    /* Table model over ProcessTelemetry::processes(), one row per process.
+    */
+    class ProcessTelemetryModel : public QAbstractTableModel
+    {
+    private:
+        ProcessTelemetry* m_telemetry = nullptr;
+        QList<ProcessStats> m_rows;
+
+    public:
+        enum Column {
+            PidColumn = 0,
+            NameColumn,
+            CpuColumn,
+            MemoryColumn,
+            ReadColumn,
+            WriteColumn,
+            ThreadsColumn,
+            ColumnCount
+        };
+
+        explicit ProcessTelemetryModel(ProcessTelemetry* telemetry, QObject* parent = nullptr)
+            : QAbstractTableModel(parent), m_telemetry(telemetry) {
+            connect(telemetry, &ProcessTelemetry::sampled, this, [this]() { refresh(); });
+            refresh();
+        }
+
+        int rowCount(const QModelIndex& parent = QModelIndex()) const override {
+            return parent.isValid() ? 0 : m_rows.count();
+        }
+
+        int columnCount(const QModelIndex& parent = QModelIndex()) const override {
+            return parent.isValid() ? 0 : ColumnCount;
+        }
+
+        QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override {
+            if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+            static const char* names[] = {"PID", "Name", "CPU %", "Memory", "Read", "Write", "Threads"};
+            return (section >= 0 && section < ColumnCount) ? QString(names[section]) : QVariant();
+        }
+
+        QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override {
+            if (!index.isValid() || index.row() >= m_rows.count()) return QVariant();
+            const ProcessStats& stats = m_rows.at(index.row());
+            const ProcessSample sample = stats.latest();
+
+            if (role == Qt::ForegroundRole && !stats.running) {
+                return QColor("#9a9a9a");
+            }
+            if (role == Qt::TextAlignmentRole && index.column() != NameColumn) {
+                return int(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            // raw numbers for sorting
+            if (role == Qt::UserRole) {
+                switch (index.column()) {
+                case PidColumn: return stats.pid;
+                case NameColumn: return stats.name;
+                case CpuColumn: return sample.cpuPercent;
+                case MemoryColumn: return sample.rssBytes;
+                case ReadColumn: return sample.readBytes;
+                case WriteColumn: return sample.writeBytes;
+                case ThreadsColumn: return sample.threads;
+                default: return QVariant();
+                }
+            }
+            if (role != Qt::DisplayRole) return QVariant();
+
+            QLocale locale;
+            switch (index.column()) {
+            case PidColumn: return stats.pid == stats.rootPid ? QString::number(stats.pid) : "  " + QString::number(stats.pid);
+            case NameColumn: return stats.running ? stats.name : stats.name + " (exited)";
+            case CpuColumn: return QString::number(sample.cpuPercent, 'f', 1);
+            case MemoryColumn: return locale.formattedDataSize(sample.rssBytes);
+            case ReadColumn: return locale.formattedDataSize(sample.readBytes);
+            case WriteColumn: return locale.formattedDataSize(sample.writeBytes);
+            case ThreadsColumn: return sample.threads;
+            default: return QVariant();
+            }
+        }
+
+        qint64 pidAt(const int row) const {
+            return (row >= 0 && row < m_rows.count()) ? m_rows.at(row).pid : 0;
+        }
+
+    private:
+        // same processes: update the cells in place, so selection and sorting survive
+        void refresh() {
+            QList<ProcessStats> rows = m_telemetry->processes();
+            bool samePids = rows.count() == m_rows.count();
+            if (samePids) {
+                QHash<qint64, int> rowByPid;
+                for (int i = 0; i < m_rows.count(); ++i)
+                    rowByPid.insert(m_rows.at(i).pid, i);
+                for (const ProcessStats& stats : rows) {
+                    auto it = rowByPid.constFind(stats.pid);
+                    if (it == rowByPid.constEnd()) {
+                        samePids = false;
+                        break;
+                    }
+                    m_rows[it.value()] = stats;
+                }
+            }
+
+            if (samePids) {
+                if (!m_rows.isEmpty())
+                    emit dataChanged(index(0, 0), index(m_rows.count() - 1, ColumnCount - 1));
+                return;
+            }
+            beginResetModel();
+            m_rows = rows;
+            endResetModel();
+        }
+    };
+
+
+    /* Compact sortable table of ProcessTelemetry.
+    */
+    class ProcessTelemetryView : public QTableView
+    {
+    private:
+        ProcessTelemetryModel* m_model = nullptr;
+        QSortFilterProxyModel* m_proxy = nullptr;
+
+    public:
+        explicit ProcessTelemetryView(ProcessTelemetry* telemetry, QWidget* parent = nullptr) : QTableView(parent) {
+            m_model = new ProcessTelemetryModel(telemetry, this);
+            initUI();
+        }
+        ~ProcessTelemetryView() = default;
+
+        void initUI() {
+            m_proxy = new QSortFilterProxyModel(this);
+            m_proxy->setSourceModel(m_model);
+            m_proxy->setSortRole(Qt::UserRole);
+            m_proxy->setDynamicSortFilter(true);
+            setModel(m_proxy);
+
+            setSortingEnabled(true);
+            sortByColumn(ProcessTelemetryModel::CpuColumn, Qt::DescendingOrder);
+            setSelectionBehavior(QAbstractItemView::SelectRows);
+            setEditTriggers(QAbstractItemView::NoEditTriggers);
+            setWordWrap(false);
+            verticalHeader()->hide();
+            verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 4);
+            horizontalHeader()->setStretchLastSection(false);
+            horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+            horizontalHeader()->setSectionResizeMode(ProcessTelemetryModel::NameColumn, QHeaderView::Stretch);
+        }
+
+        ProcessTelemetryModel* telemetryModel() const { return m_model; }
+
+        qint64 currentPid() const {
+            return m_model->pidAt(m_proxy->mapToSource(currentIndex()).row());
+        }
+
+        virtual QSize sizeHint() const override { return QSize(520, 240); }
+    };
+
+}   // namespace utilWidgets
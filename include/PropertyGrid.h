@@ -0,0 +1,271 @@
+#pragma once
+#include <QHash>
+#include <QMenu>
+#include <QVector>
+#include <QVariant>
+#include <QTreeView>
+#include <QHeaderView>
+#include <QAbstractTableModel>
+#include "utils.h"
+
+
+/* One label/value/override row of a PropertyGrid.
+The value type decides the editor created by the delegate (QString, int, double, bool, ...).
+*/
+struct PropertyGridItem
+{
+    QString name;
+    QVariant value;
+    QString toolTip;
+    bool override = false;
+};
+
+
+class PropertyGridModel : public QAbstractTableModel
+{
+Q_OBJECT
+
+signals:
+    void overrideChanged(int row, bool override);
+    void valueChanged(int row, const QVariant& value);
+
+private:
+    QVector<PropertyGridItem> m_items;
+    QHash<QString, int> m_rowByName;
+    QColor m_overrideColor = QColor("#FF8000");
+
+public:
+    enum Column {
+        NameColumn = 0,
+        ValueColumn,
+        ColumnCount
+    };
+
+    explicit PropertyGridModel(QObject* parent = nullptr) : QAbstractTableModel(parent) {}
+    ~PropertyGridModel() override = default;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : m_items.count();
+    }
+
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : ColumnCount;
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override {
+        if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+        return section == NameColumn ? QString("Name") : QString("Value");
+    }
+
+    Qt::ItemFlags flags(const QModelIndex& index) const override {
+        if (!index.isValid()) return Qt::NoItemFlags;
+        Qt::ItemFlags result = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+        if (index.column() == ValueColumn) result |= Qt::ItemIsEditable;
+        return result;
+    }
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override {
+        if (!index.isValid() || index.row() >= m_items.count()) return QVariant();
+        const PropertyGridItem& item = m_items.at(index.row());
+
+        if (index.column() == NameColumn) {
+            switch (role) {
+            case Qt::DisplayRole:
+                return item.name;
+            case Qt::ToolTipRole:
+                return item.override ? QString("Overrided") : item.toolTip;
+            case Qt::FontRole:
+                if (item.override) {
+                    QFont font;
+                    font.setBold(true);
+                    font.setItalic(true);
+                    return font;
+                }
+                return QVariant();
+            case Qt::ForegroundRole:
+                return item.override ? QVariant(m_overrideColor) : QVariant();
+            default:
+                return QVariant();
+            }
+        }
+
+        if (role == Qt::DisplayRole || role == Qt::EditRole) {
+            return item.value;
+        }
+        if (role == Qt::ToolTipRole) {
+            return item.toolTip;
+        }
+        return QVariant();
+    }
+
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override {
+        if (!index.isValid() || index.column() != ValueColumn || role != Qt::EditRole) return false;
+        return setValue(index.row(), value);
+    }
+
+    /* Replace all rows at once. A single model reset keeps this O(n) for thousands of rows.
+    Names are the lookup key, rows repeating an earlier name are skipped with a warning.
+    */
+    void setItems(const QVector<PropertyGridItem>& items) {
+        beginResetModel();
+        m_items.clear();
+        m_items.reserve(items.count());
+        m_rowByName.clear();
+        m_rowByName.reserve(items.count());
+        for (const PropertyGridItem& item : items) {
+            if (m_rowByName.contains(item.name)) {
+                qWarning() << "PropertyGridModel: duplicate property name skipped:" << item.name;
+                continue;
+            }
+            m_rowByName.insert(item.name, int(m_items.count()));
+            m_items.append(item);
+        }
+        endResetModel();
+    }
+
+    // the new row, or -1 when 'name' is already taken
+    int addItem(const QString& name, const QVariant& value, const QString& toolTip = QString()) {
+        if (m_rowByName.contains(name)) {
+            qWarning() << "PropertyGridModel: duplicate property name rejected:" << name;
+            return -1;
+        }
+        int row = m_items.count();
+        beginInsertRows(QModelIndex(), row, row);
+        m_items.append({name, value, toolTip, false});
+        m_rowByName.insert(name, row);
+        endInsertRows();
+        return row;
+    }
+
+    void clear() {
+        setItems({});
+    }
+
+    const QVector<PropertyGridItem>& items() const { return m_items; }
+
+    int indexOf(const QString& name) const {
+        return m_rowByName.value(name, -1);
+    }
+
+    QString getName(int row) const {
+        return isValidRow(row) ? m_items.at(row).name : QString();
+    }
+
+    QVariant getValue(int row) const {
+        return isValidRow(row) ? m_items.at(row).value : QVariant();
+    }
+
+    bool setValue(int row, const QVariant& value) {
+        if (!isValidRow(row)) return false;
+        PropertyGridItem& item = m_items[row];
+        if (item.value == value) return true;
+
+        item.value = value;
+        QModelIndex idx = index(row, ValueColumn);
+        emit dataChanged(idx, idx, {Qt::DisplayRole, Qt::EditRole});
+        emit valueChanged(row, value);
+        return true;
+    }
+
+    bool isOverride(int row) const {
+        return isValidRow(row) && m_items.at(row).override;
+    }
+
+    void setOverride(int row, bool override) {
+        if (!isValidRow(row)) return;
+        PropertyGridItem& item = m_items[row];
+        if (item.override == override) return;
+
+        item.override = override;
+        QModelIndex idx = index(row, NameColumn);
+        emit dataChanged(idx, idx, {Qt::FontRole, Qt::ForegroundRole, Qt::ToolTipRole});
+        emit overrideChanged(row, override);
+    }
+
+    QColor getOverrideColor() const { return m_overrideColor; }
+
+private:
+    bool isValidRow(int row) const {
+        return row >= 0 && row < m_items.count();
+    }
+
+};
+
+
+/* Virtualized replacement for large panels of OverrideFieldWidget<T>.
+Rows are painted by the item delegate and only the row being edited gets a real editor widget,
+so opening a panel with thousands of properties costs about as much as the visible rows.
+The name column keeps the OverrideFieldWidget look and its context menu toggles the override.
+
+Example usage:
+    PropertyGrid* grid = new PropertyGrid(this);
+    grid->propertyModel()->addItem("Samples", 64);
+    grid->propertyModel()->addItem("Output", QString("beauty.exr"));
+    connect(grid, &PropertyGrid::overrideChanged, this, [](int row, bool override) { ... });
+*/
+class PropertyGrid : public QTreeView
+{
+Q_OBJECT
+
+signals:
+    void overrideChanged(int row, bool override);
+    void valueChanged(int row, const QVariant& value);
+
+private:
+    PropertyGridModel* m_model = nullptr;
+
+public:
+    explicit PropertyGrid(QWidget* parent = nullptr) : QTreeView(parent) {
+        initUI();
+    }
+
+    ~PropertyGrid() override = default;
+
+    void initUI() {
+        m_model = new PropertyGridModel(this);
+        setModel(m_model);
+
+        setUniformRowHeights(true);
+        setRootIsDecorated(false);
+        setItemsExpandable(false);
+        setAlternatingRowColors(true);
+        setSelectionBehavior(QAbstractItemView::SelectRows);
+        setSelectionMode(QAbstractItemView::SingleSelection);
+        setEditTriggers(QAbstractItemView::DoubleClicked
+                        | QAbstractItemView::SelectedClicked
+                        | QAbstractItemView::EditKeyPressed);
+        setContextMenuPolicy(Qt::CustomContextMenu);
+
+        header()->setStretchLastSection(true);
+        header()->setSectionResizeMode(PropertyGridModel::NameColumn, QHeaderView::Interactive);
+        header()->resizeSection(PropertyGridModel::NameColumn, 160);
+
+        // signals
+        connect(m_model, &PropertyGridModel::overrideChanged, this, &PropertyGrid::overrideChanged);
+        connect(m_model, &PropertyGridModel::valueChanged, this, &PropertyGrid::valueChanged);
+        connect(this, &QWidget::customContextMenuRequested, this, &PropertyGrid::on_customContextMenuRequested);
+    }
+
+    PropertyGridModel* propertyModel() const { return m_model; }
+
+    bool isOverride(int row) const { return m_model->isOverride(row); }
+    void setOverride(int row, bool override) { m_model->setOverride(row, override); }
+
+    void on_customContextMenuRequested(const QPoint& pos) {
+        QModelIndex index = indexAt(pos);
+        if (!index.isValid() || index.column() != PropertyGridModel::NameColumn) return;
+
+        const int row = index.row();
+        QMenu menu(this);
+
+        QString actionName = isOverride(row) ? "Disable Override" : "Enable Override";
+        menu.addAction(actionName, this, [this, row]() {
+            setOverride(row, !isOverride(row));
+        });
+
+        menu.exec(viewport()->mapToGlobal(pos));
+    }
+
+    virtual QSize sizeHint() const override { return QSize(320, 400); }
+
+};
@@ -0,0 +1,474 @@
+#pragma once
+#include <QHash>
+#include <QQueue>
+#include <QTimer>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QProcess>
+#include <QJsonArray>
+#include <QtEndian>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include "utils.h"
+
+
+/* One script to run inside a warm Python worker, as if started with "python script args...".
+*/
+struct PythonTask
+{
+    QString script;
+    QStringList arguments;
+    QString workingDirectory;
+};
+
+
+struct PythonTaskResult
+{
+    qint64 id = -1;
+    int exitCode = -1;          // sys.exit() code, 1 for an uncaught exception
+    bool crashed = false;       // the worker died or timed out while running the task
+    bool cancelled = false;
+    QString output;             // what the script printed to sys.stdout
+    QString errorOutput;        // sys.stderr
+    QString traceback;          // uncaught exception, if any
+    qint64 workerPid = 0;
+    qint64 elapsedMs = 0;
+
+    bool ok() const { return !crashed && !cancelled && exitCode == 0; }
+};
+
+
+/* Keeps a few long-lived Python interpreters around and runs scripts inside them,
+so a batch of small scripts pays the interpreter startup (and the shared imports)
+once per worker instead of once per script.
+
+Workers talk over stdin/stdout with frames of a 4-byte big-endian length and a JSON body;
+the script's own stdout/stderr are redirected into frames, and the original fds 0 and 1 are
+moved away, so a script reading stdin or native code writing to fd 1 can not corrupt the protocol;
+tasks see an empty stdin. A worker is restarted
+when it crashes or times out, and recycled after maxTasksPerWorker() tasks to bound leaks.
+
+Scripts share the interpreter: modules imported by one task stay imported for the next.
+Scripts that rely on a pristine interpreter should go through ProcessScheduler instead.
+
+Example usage:
+    PythonWorkerPool* pool = new PythonWorkerPool(this);
+    pool->setPyPaths({general_util::getPythonScriptPath()});
+    connect(pool, &PythonWorkerPool::taskFinished, this, [](const PythonTaskResult& result) {
+        qDebug() << result.id << result.exitCode << result.output;
+    });
+    for (const QString& script : general_util::getPythonFilePaths(dir))
+        pool->submit({script, {"--fast"}, QString()});
+*/
+class PythonWorkerPool : public QObject
+{
+Q_OBJECT
+
+signals:
+    void taskStarted(qint64 id, qint64 workerPid);
+    void taskOutput(qint64 id, const QString& text, bool isError);
+    void taskFinished(const PythonTaskResult& result);
+    void workerRestarted(int index, const QString& reason);
+    // the queue is empty and no task is running
+    void idle();
+
+private:
+    struct Pending {
+        qint64 id = -1;
+        PythonTask task;
+    };
+
+    struct Worker {
+        int index = 0;
+        QProcess* process = nullptr;
+        QTimer* timeout = nullptr;
+        QByteArray buffer;
+        bool ready = false;
+        int tasksRun = 0;
+        Pending current;
+        PythonTaskResult result;
+        QElapsedTimer elapsed;
+    };
+
+    QString m_python = "python";
+    QStringList m_pyPaths;
+    int m_workerCount = qBound(1, QThread::idealThreadCount(), 4);
+    int m_maxTasksPerWorker = 100;
+    int m_timeoutMs = 0;
+    int m_startFailures = 0;
+
+    QVector<Worker*> m_workers;
+    QVector<Worker*> m_retired;     // deleted from the event loop, callers up the stack may still use them
+    QQueue<Pending> m_queue;
+    qint64 m_nextId = 1;
+    bool m_shuttingDown = false;
+
+public:
+    static constexpr int MaxStartFailures = 3;
+
+    explicit PythonWorkerPool(QObject* parent = nullptr) : QObject(parent) {}
+
+    ~PythonWorkerPool() override {
+        shutdown();
+        qDeleteAll(m_retired);
+    }
+
+    QString getPython() const { return m_python; }
+    void setPython(const QString& python) { m_python = python; }
+
+    QStringList getPyPaths() const { return m_pyPaths; }
+    void setPyPaths(const QStringList& pyPaths) { m_pyPaths = pyPaths; }
+
+    int workerCount() const { return m_workerCount; }
+    void setWorkerCount(const int count) { m_workerCount = qMax(1, count); }
+
+    int maxTasksPerWorker() const { return m_maxTasksPerWorker; }
+    void setMaxTasksPerWorker(const int count) { m_maxTasksPerWorker = qMax(1, count); }
+
+    // per task, 0 - no timeout. A task that times out takes its worker down with it.
+    int timeout() const { return m_timeoutMs; }
+    void setTimeout(const int ms) { m_timeoutMs = qMax(0, ms); }
+
+    int pendingCount() const { return m_queue.count(); }
+
+    /* Start the workers ahead of the first task. Settings above apply to workers started afterwards.
+    */
+    void start() {
+        m_shuttingDown = false;
+        while (m_workers.count() < m_workerCount)
+            m_workers.append(nullptr);
+        for (int i = 0; i < m_workerCount; ++i) {
+            if (m_workers.at(i) == nullptr) m_workers[i] = startWorker(i);
+        }
+    }
+
+    qint64 submit(const PythonTask& task) {
+        const qint64 id = m_nextId ++;
+        m_queue.enqueue({id, task});
+        start();
+        dispatch();
+        return id;
+    }
+
+    /* Drop a queued task, or kill the worker running it (the worker is restarted).
+    */
+    bool cancel(const qint64 id) {
+        for (int i = 0; i < m_queue.count(); ++i) {
+            if (m_queue.at(i).id != id) continue;
+            PythonTaskResult result;
+            result.id = id;
+            result.cancelled = true;
+            m_queue.removeAt(i);
+            emit taskFinished(result);
+            checkIdle();
+            return true;
+        }
+        for (Worker* worker : std::as_const(m_workers)) {
+            if (worker && worker->current.id == id) {
+                worker->result.cancelled = true;
+                worker->process->kill();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Stop all workers; queued tasks are dropped without being reported.
+    */
+    void shutdown() {
+        m_shuttingDown = true;
+        m_queue.clear();
+        for (Worker*& worker : m_workers) {
+            if (worker == nullptr) continue;
+            disconnect(worker->process, nullptr, this, nullptr);
+            worker->process->closeWriteChannel();
+            if (!worker->process->waitForFinished(1000)) worker->process->kill();
+            worker->process->deleteLater();
+            retire(worker);
+            worker = nullptr;
+        }
+        m_workers.clear();
+    }
+
+    /* Python side of the protocol, run with "python -u -c".
+    */
+    static QString bootstrapCode() {
+        return QString::fromLatin1(R"PY(
+import io, os, sys, json, struct, runpy, traceback
+_out = os.fdopen(os.dup(1), 'wb', buffering=0)
+os.dup2(2, 1)
+_in = os.fdopen(os.dup(0), 'rb', buffering=0)
+_null = os.open(os.devnull, os.O_RDONLY)
+os.dup2(_null, 0)
+os.close(_null)
+sys.stdin = _stdin = open(os.devnull, 'r')
+
+def _send(msg):
+    data = json.dumps(msg).encode('utf-8')
+    _out.write(struct.pack('>I', len(data)) + data)
+
+def _read(n):
+    buf = b''
+    while len(buf) < n:
+        chunk = _in.read(n - len(buf))
+        if not chunk:
+            return None
+        buf += chunk
+    return buf
+
+class _Stream(io.TextIOBase):
+    def __init__(self, id, kind):
+        self.id, self.kind, self.buf = id, kind, []
+    def writable(self):
+        return True
+    def write(self, s):
+        self.buf.append(s)
+        if '\n' in s or sum(len(b) for b in self.buf) > 8192:
+            self.flush()
+        return len(s)
+    def flush(self):
+        if self.buf:
+            _send({'id': self.id, 'type': self.kind, 'data': ''.join(self.buf)})
+            self.buf = []
+
+_send({'type': 'ready', 'pid': os.getpid()})
+while True:
+    header = _read(4)
+    if header is None:
+        break
+    body = _read(struct.unpack('>I', header)[0])
+    if body is None:
+        break
+    req = json.loads(body.decode('utf-8'))
+    saved = (sys.stdout, sys.stderr, sys.argv, os.getcwd(), sys.path[:])
+    sys.stdout, sys.stderr = _Stream(req['id'], 'stdout'), _Stream(req['id'], 'stderr')
+    code, error = 0, ''
+    try:
+        if req.get('cwd'):
+            os.chdir(req['cwd'])
+        sys.argv = [req['script']] + req.get('args', [])
+        sys.path.insert(0, os.path.dirname(os.path.abspath(req['script'])))
+        runpy.run_path(req['script'], run_name='__main__')
+    except SystemExit as e:
+        code = e.code if isinstance(e.code, int) else (0 if e.code is None else 1)
+        if e.code is not None and not isinstance(e.code, int):
+            error = str(e.code)
+    except BaseException:
+        code, error = 1, traceback.format_exc()
+    finally:
+        sys.stdout.flush()
+        sys.stderr.flush()
+        sys.stdout, sys.stderr, sys.argv = saved[0], saved[1], saved[2]
+        sys.stdin = _stdin
+        os.chdir(saved[3])
+        sys.path[:] = saved[4]
+    _send({'id': req['id'], 'type': 'result', 'exitCode': code, 'error': error})
+)PY");
+    }
+
+private:
+    Worker* startWorker(const int index) {
+        Worker* worker = new Worker();
+        worker->index = index;
+
+        QProcess* proc = general_util::getWorkProcess(m_pyPaths);
+        proc->setParent(this);
+        proc->setProcessChannelMode(QProcess::SeparateChannels);
+        worker->process = proc;
+
+        worker->timeout = new QTimer(proc);
+        worker->timeout->setSingleShot(true);
+        connect(worker->timeout, &QTimer::timeout, this, [worker]() {
+            worker->result.crashed = true;
+            worker->process->kill();
+        });
+
+        connect(proc, &QProcess::readyReadStandardOutput, this, [this, worker]() {
+            worker->buffer.append(worker->process->readAllStandardOutput());
+            readFrames(worker);
+        });
+        connect(proc, &QProcess::readyReadStandardError, this, [this, worker]() {
+            // fd-level output of native code, attributed to the running task
+            const QString text = QString::fromUtf8(worker->process->readAllStandardError());
+            if (worker->current.id < 0) return;
+            worker->result.errorOutput += text;
+            emit taskOutput(worker->current.id, text, true);
+        });
+        connect(proc, &QProcess::finished, this, [this, worker](int exitCode, QProcess::ExitStatus) {
+            on_workerDied(worker, QString("worker exited with code %1").arg(exitCode));
+        });
+        connect(proc, &QProcess::errorOccurred, this, [this, worker](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart)
+                on_workerDied(worker, worker->process->errorString());
+        });
+
+        proc->start(m_python, {"-u", "-c", bootstrapCode()});
+        return worker;
+    }
+
+    void readFrames(Worker* worker) {
+        // slots connected to our signals may cancel, recycle or shut down 'worker'
+        while (isActive(worker) && worker->buffer.size() >= 4) {
+            const quint32 length = qFromBigEndian<quint32>(worker->buffer.constData());
+            if (quint32(worker->buffer.size() - 4) < length) return;
+
+            const QJsonObject frame = QJsonDocument::fromJson(worker->buffer.mid(4, length)).object();
+            worker->buffer.remove(0, 4 + length);
+            if (!handleFrame(worker, frame)) return;
+        }
+    }
+
+    bool isActive(Worker* worker) const {
+        return worker->index < m_workers.count() && m_workers.at(worker->index) == worker;
+    }
+
+    // false once the task finished, nothing more is read from 'worker' then
+    bool handleFrame(Worker* worker, const QJsonObject& frame) {
+        const QString type = frame.value("type").toString();
+        if (type == "ready") {
+            worker->ready = true;
+            m_startFailures = 0;
+            dispatch();
+            return true;
+        }
+
+        const qint64 id = frame.value("id").toInteger(-1);
+        if (id != worker->current.id) return true;
+
+        if (type == "stdout" || type == "stderr") {
+            const QString text = frame.value("data").toString();
+            const bool isError = type == "stderr";
+            (isError ? worker->result.errorOutput : worker->result.output) += text;
+            emit taskOutput(id, text, isError);
+        } else if (type == "result") {
+            worker->timeout->stop();
+            worker->result.exitCode = frame.value("exitCode").toInt(1);
+            worker->result.traceback = frame.value("error").toString();
+            worker->result.elapsedMs = worker->elapsed.elapsed();
+            worker->tasksRun ++;
+
+            const PythonTaskResult result = worker->result;
+            worker->current = Pending();
+            worker->result = PythonTaskResult();
+
+            if (worker->tasksRun >= m_maxTasksPerWorker) recycle(worker, "recycled");
+            emit taskFinished(result);
+            dispatch();
+            checkIdle();
+            return false;
+        }
+        return true;
+    }
+
+    void dispatch() {
+        if (m_shuttingDown) return;
+        for (Worker* worker : std::as_const(m_workers)) {
+            if (m_queue.isEmpty()) return;
+            if (worker == nullptr || !worker->ready || worker->current.id >= 0) continue;
+            send(worker, m_queue.dequeue());
+        }
+    }
+
+    void send(Worker* worker, Pending&& pending) {
+        QJsonObject request;
+        request.insert("id", pending.id);
+        request.insert("script", pending.task.script);
+        request.insert("args", QJsonArray::fromStringList(pending.task.arguments));
+        request.insert("cwd", pending.task.workingDirectory);
+        const QByteArray body = QJsonDocument(request).toJson(QJsonDocument::Compact);
+
+        char header[4];
+        qToBigEndian<quint32>(quint32(body.size()), header);
+
+        worker->result = PythonTaskResult();
+        worker->result.id = pending.id;
+        worker->result.workerPid = worker->process->processId();
+        worker->current = std::move(pending);
+        worker->elapsed.start();
+        if (m_timeoutMs > 0) worker->timeout->start(m_timeoutMs);
+
+        worker->process->write(header, 4);
+        worker->process->write(body);
+        emit taskStarted(worker->current.id, worker->result.workerPid);
+    }
+
+    // replace 'worker' by a fresh one, the old process exits on end of input
+    void recycle(Worker* worker, const QString& reason) {
+        const int index = worker->index;
+        QProcess* proc = worker->process;
+        disconnect(proc, nullptr, this, nullptr);
+        connect(proc, &QProcess::finished, proc, &QObject::deleteLater);
+        proc->closeWriteChannel();
+        QTimer::singleShot(5000, proc, [proc]() { proc->kill(); });
+
+        retire(worker);
+        m_workers[index] = m_shuttingDown ? nullptr : startWorker(index);
+        emit workerRestarted(index, reason);
+    }
+
+    void on_workerDied(Worker* worker, const QString& reason) {
+        const int index = worker->index;
+        if (!worker->ready) m_startFailures ++;
+
+        if (worker->current.id >= 0) {
+            PythonTaskResult result = worker->result;
+            result.crashed = !result.cancelled;
+            result.traceback = result.traceback.isEmpty() ? reason : result.traceback;
+            result.elapsedMs = worker->elapsed.elapsed();
+            worker->current = Pending();
+            emit taskFinished(result);
+        }
+
+        QProcess* proc = worker->process;
+        disconnect(proc, nullptr, this, nullptr);
+        proc->deleteLater();
+        retire(worker);
+        m_workers[index] = nullptr;
+
+        if (m_shuttingDown) return;
+
+        // a worker that can not even start (wrong interpreter, broken PYTHONPATH) is not retried forever
+        if (m_startFailures >= MaxStartFailures) {
+            qWarning() << "PythonWorkerPool: workers fail to start:" << reason;
+            failQueued(reason);
+            return;
+        }
+        m_workers[index] = startWorker(index);
+        emit workerRestarted(index, reason);
+        checkIdle();
+    }
+
+    void retire(Worker* worker) {
+        worker->timeout->stop();
+        if (m_retired.isEmpty()) {
+            QTimer::singleShot(0, this, [this]() {
+                qDeleteAll(m_retired);
+                m_retired.clear();
+            });
+        }
+        m_retired.append(worker);
+    }
+
+    void failQueued(const QString& reason) {
+        while (!m_queue.isEmpty()) {
+            PythonTaskResult result;
+            result.id = m_queue.dequeue().id;
+            result.crashed = true;
+            result.traceback = reason;
+            emit taskFinished(result);
+        }
+        m_startFailures = 0;
+        checkIdle();
+    }
+
+    void checkIdle() {
+        if (!m_queue.isEmpty()) return;
+        for (Worker* worker : std::as_const(m_workers)) {
+            if (worker && worker->current.id >= 0) return;
+        }
+        emit idle();
+    }
+
+};
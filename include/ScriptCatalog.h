@@ -0,0 +1,583 @@
+#pragma once
+#include <utility>
+#include <QDir>
+#include <QSet>
+#include <QHash>
+#include <QFile>
+#include <QTimer>
+#include <QObject>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QFutureWatcher>
+#include <QFileSystemWatcher>
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+#include "DirectoryScanner.h"
+
+
+struct ScriptInfo
+{
+    QString path;
+    qint64 size = 0;
+    qint64 mtime = 0;               // ms since epoch
+    QString docstring;              // module docstring, cleaned up like inspect.cleandoc()
+    QStringList entryPoints;        // public top-level functions, "__main__" for an 'if __name__ == "__main__":' block
+
+    bool isValid() const { return !path.isEmpty(); }
+};
+
+
+namespace general_util {
+
+    namespace detail {
+        inline QString cleanDocstring(QString text) {
+            text.remove(QChar('\r'));
+            QStringList lines = text.split(QChar('\n'));
+
+            int indent = -1;
+            for (int i = 1; i < lines.count(); ++i) {
+                const QString& line = lines.at(i);
+                int n = 0;
+                while (n < line.size() && line.at(n).isSpace()) ++n;
+                if (n < line.size() && (indent < 0 || n < indent)) indent = n;
+            }
+            lines[0] = lines.at(0).trimmed();
+            for (int i = 1; i < lines.count(); ++i)
+                lines[i] = indent > 0 ? lines.at(i).mid(indent) : lines.at(i);
+
+            while (!lines.isEmpty() && lines.first().trimmed().isEmpty()) lines.removeFirst();
+            while (!lines.isEmpty() && lines.last().trimmed().isEmpty()) lines.removeLast();
+            return lines.join(QChar('\n'));
+        }
+    }
+
+    /* Module docstring of Python 'source': the first statement when it is a string literal.
+    Comments, the shebang and the coding line before it are skipped. Escapes are not processed.
+    */
+    inline QString pythonDocstring(const QString& source) {
+        const int n = int(source.size());
+        int pos = 0;
+        while (pos < n) {
+            const QChar c = source.at(pos);
+            if (c == QChar('#')) {
+                pos = int(source.indexOf(QChar('\n'), pos));
+                if (pos < 0) return QString();
+                ++pos;
+            } else if (c.isSpace()) {
+                ++pos;
+            } else {
+                break;
+            }
+        }
+
+        // r"..." and u"..." prefixes, b"..." and f"..." are not docstrings
+        for (int i = 0; i < 2 && pos < n && QStringLiteral("rRuU").contains(source.at(pos)); ++i) ++pos;
+        if (pos >= n) return QString();
+
+        const QChar quote = source.at(pos);
+        if (quote != QChar('"') && quote != QChar('\'')) return QString();
+
+        const QString triple(3, quote);
+        if (QStringView(source).mid(pos, 3) == triple) {
+            const int end = int(source.indexOf(triple, pos + 3));
+            if (end < 0) return QString();
+            return detail::cleanDocstring(source.mid(pos + 3, end - pos - 3));
+        }
+
+        const int lineEnd = int(source.indexOf(QChar('\n'), pos));
+        const int end = int(source.indexOf(quote, pos + 1));
+        if (end < 0 || (lineEnd >= 0 && end > lineEnd)) return QString();
+        return source.mid(pos + 1, end - pos - 1).trimmed();
+    }
+
+    /* Public top-level functions of Python 'source' (not starting with '_'),
+    plus "__main__" when it runs as a script.
+    */
+    inline QStringList pythonEntryPoints(const QString& source) {
+        static const QRegularExpression defRegex(R"(^(?:async\s+)?def\s+([A-Za-z]\w*)\s*\()", QRegularExpression::MultilineOption);
+        static const QRegularExpression mainRegex(R"(^if\s+__name__\s*==\s*['"]__main__['"]\s*:)", QRegularExpression::MultilineOption);
+
+        QStringList result;
+        QRegularExpressionMatchIterator it = defRegex.globalMatch(source);
+        while (it.hasNext()) {
+            const QString name = it.next().captured(1);
+            if (!result.contains(name)) result.append(name);
+        }
+        if (mainRegex.match(source).hasMatch()) result.append("__main__");
+        return result;
+    }
+
+    /* Read 'path' and extract its metadata. An unreadable file still yields an entry
+    with path, size and mtime, so it stays listed.
+    */
+    inline ScriptInfo readScriptInfo(const QString& path, const qint64 size, const qint64 mtime) {
+        constexpr qint64 MaxSourceSize = 4 * 1024 * 1024;
+
+        ScriptInfo info;
+        info.path = path;
+        info.size = size;
+        info.mtime = mtime;
+
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly)) {
+            const QString source = QString::fromUtf8(file.read(MaxSourceSize));
+            info.docstring = pythonDocstring(source);
+            info.entryPoints = pythonEntryPoints(source);
+        }
+        return info;
+    }
+
+}   // namespace general_util
+
+
+/* Persistent catalog of the scripts under a set of root directories.
+Every entry keeps path, size, mtime, docstring and entry points, and the whole catalog is
+stored in an index file. load() reads the index synchronously, so scripts() is usable
+right away, and then revalidates in the background: only directories whose mtime changed
+are listed again, and only files whose size or mtime changed are read again.
+An unchanged tree costs one stat per directory.
+
+While loaded, the directories are watched with QFileSystemWatcher; bursts of changes are
+debounced and applied incrementally, reported through catalogChanged().
+A directory mtime only changes when entries are created, removed or renamed, which covers
+editors that save through a temporary file. Files rewritten in place are picked up by rescan(),
+or as soon as anything else in their directory changes.
+
+Example usage:
+    ScriptCatalog* catalog = new ScriptCatalog(this);
+    catalog->setRoots({general_util::getPythonScriptPath()});
+    connect(catalog, &ScriptCatalog::catalogChanged, this, [](const QStringList& added, const QStringList& modified, const QStringList& removed) { ... });
+    catalog->load();
+
+    for (const ScriptInfo& info : catalog->scripts()) { ... }
+*/
+class ScriptCatalog : public QObject
+{
+Q_OBJECT
+
+signals:
+    void ready();               // the first revalidation after load() is applied
+    void catalogChanged(const QStringList& added, const QStringList& modified, const QStringList& removed);
+
+public:
+    struct Directory {
+        qint64 mtime = 0;
+        QStringList subdirs;
+        QStringList scripts;
+    };
+
+private:
+    struct Index {
+        QStringList roots;
+        QHash<QString, Directory> dirs;
+        QHash<QString, ScriptInfo> scripts;
+    };
+
+    struct Delta {
+        QStringList roots;                  // of the snapshot the delta was computed from
+        QHash<QString, Directory> dirs;
+        QStringList removedDirs;
+        QStringList removedScripts;
+        QList<ScriptInfo> updated;
+    };
+
+    static constexpr quint32 IndexMagic = 0x53434154;       // "SCAT"
+    static constexpr quint8 IndexVersion = 1;
+
+    general_util::DirectoryScanOptions m_options;
+    QString m_indexPath;
+    Index m_index;
+    bool m_loaded = false;
+    bool m_ready = false;
+    bool m_dirty = false;
+
+    QFileSystemWatcher* m_watcher = nullptr;
+    QTimer* m_debounceTimer = nullptr;
+    QTimer* m_saveTimer = nullptr;
+    QFutureWatcher<Delta>* m_futureWatcher = nullptr;
+    QSet<QString> m_changedDirs;        // reported by the watcher, waiting for the debounce
+    QSet<QString> m_pendingDirs;
+    QSet<QString> m_pendingForced;
+    bool m_pendingFull = false;
+
+public:
+    explicit ScriptCatalog(QObject* parent = nullptr) : QObject(parent) {
+        m_options.nameFilters = {"*.py"};
+        m_options.excludeFiles = {"__init__.py"};
+        m_indexPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/script_catalog.idx";
+
+        m_watcher = new QFileSystemWatcher(this);
+
+        m_debounceTimer = new QTimer(this);
+        m_debounceTimer->setSingleShot(true);
+        m_debounceTimer->setInterval(300);
+
+        m_saveTimer = new QTimer(this);
+        m_saveTimer->setSingleShot(true);
+        m_saveTimer->setInterval(2000);
+
+        m_futureWatcher = new QFutureWatcher<Delta>(this);
+
+        // connections
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString& dir) {
+            m_changedDirs.insert(dir);
+            m_debounceTimer->start();
+        });
+        connect(m_debounceTimer, &QTimer::timeout, this, [this]() {
+            const QSet<QString> dirs = std::exchange(m_changedDirs, {});
+            queue(dirs.values(), true, false);
+        });
+        connect(m_saveTimer, &QTimer::timeout, this, [this]() { save(); });
+        connect(m_futureWatcher, &QFutureWatcher<Delta>::finished, this, &ScriptCatalog::on_revalidated);
+    }
+
+    ~ScriptCatalog() override {
+        m_futureWatcher->waitForFinished();
+        if (m_dirty) save();
+    }
+
+    void setIndexPath(const QString& path) { m_indexPath = path; }
+    QString getIndexPath() const { return m_indexPath; }
+
+    // file filters and excluded directories, set before load()
+    void setOptions(const general_util::DirectoryScanOptions& options) { m_options = options; }
+    general_util::DirectoryScanOptions getOptions() const { return m_options; }
+
+    void setDebounceInterval(const int msecs) { m_debounceTimer->setInterval(msecs); }
+
+    void setRoots(const QStringList& roots) {
+        QStringList cleaned;
+        for (const QString& root : roots) {
+            const QString dir = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+            if (!cleaned.contains(dir)) cleaned.append(dir);
+        }
+        if (!m_loaded) {
+            m_index.roots = cleaned;
+            return;
+        }
+
+        Delta delta;
+        QStringList added;
+        for (const QString& root : std::as_const(m_index.roots)) {
+            if (!cleaned.contains(root)) removeTree(m_index, root, delta);
+        }
+        for (const QString& root : std::as_const(cleaned)) {
+            if (!m_index.roots.contains(root)) added.append(root);
+        }
+        m_index.roots = cleaned;
+        applyDelta(delta);
+        queue(added, false, false);
+    }
+
+    QStringList getRoots() const { return m_index.roots; }
+
+    /* Read the index and start revalidating it. Roots set before keep precedence over the
+    stored ones. Returns false when there was no usable index (the first scan then reads everything).
+    */
+    bool load() {
+        Index stored;
+        bool ok = false;
+        QFile file(m_indexPath);
+        if (file.open(QIODevice::ReadOnly)) ok = fromByteArray(file.readAll(), signature(), stored);
+
+        const QStringList roots = m_index.roots.isEmpty() ? stored.roots : m_index.roots;
+        m_index = ok ? stored : Index();
+        m_loaded = true;
+        setRoots(roots);
+        queue(m_index.roots, false, false);
+        updateWatcher();
+        return ok;
+    }
+
+    // check every directory and file, for files rewritten in place
+    void rescan() {
+        queue(m_index.roots, false, true);
+    }
+
+    bool save() {
+        m_saveTimer->stop();
+        QDir().mkpath(QFileInfo(m_indexPath).absolutePath());
+        QSaveFile file(m_indexPath);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        file.write(toByteArray(m_index, signature()));
+        if (!file.commit()) return false;
+        m_dirty = false;
+        return true;
+    }
+
+    bool isReady() const { return m_ready; }
+    bool isBusy() const { return m_futureWatcher->isRunning() || m_debounceTimer->isActive(); }
+
+    int count() const { return m_index.scripts.count(); }
+    bool contains(const QString& path) const { return m_index.scripts.contains(path); }
+    ScriptInfo script(const QString& path) const { return m_index.scripts.value(path); }
+
+    // sorted by path
+    QList<ScriptInfo> scripts() const {
+        QStringList paths = m_index.scripts.keys();
+        paths.sort();
+        QList<ScriptInfo> result;
+        result.reserve(paths.count());
+        for (const QString& path : std::as_const(paths))
+            result.append(m_index.scripts.value(path));
+        return result;
+    }
+
+private:
+    QString signature() const {
+        return (m_options.nameFilters + QStringList{"|"} + m_options.excludeFiles + QStringList{"|"} + m_options.excludeDirs).join(QChar('\n'))
+               + QString("|%1%2").arg(m_options.recursive).arg(m_options.followSymlinks);
+    }
+
+    void queue(const QStringList& dirs, const bool forced, const bool full) {
+        for (const QString& dir : dirs) {
+            m_pendingDirs.insert(dir);
+            if (forced) m_pendingForced.insert(dir);
+        }
+        m_pendingFull = m_pendingFull || full;
+        if (!m_futureWatcher->isRunning()) startNext();
+    }
+
+    void startNext() {
+        if (m_pendingDirs.isEmpty()) return;
+
+        // directories queued before setRoots() removed their root are not listed again
+        QStringList dirs;
+        for (const QString& dir : std::as_const(m_pendingDirs)) {
+            if (isUnderRoots(dir)) dirs.append(dir);
+        }
+        const QSet<QString> forced = std::exchange(m_pendingForced, {});
+        const bool full = std::exchange(m_pendingFull, false);
+        m_pendingDirs.clear();
+        if (dirs.isEmpty()) return;
+
+        // the hashes are implicitly shared, the worker reads a snapshot without copying it
+        const Index snapshot = m_index;
+        const general_util::DirectoryScanOptions options = m_options;
+        m_futureWatcher->setFuture(QtConcurrent::run([snapshot, dirs, forced, full, options]() {
+            return revalidate(snapshot, dirs, forced, full, options);
+        }));
+    }
+
+    void on_revalidated() {
+        Delta delta = m_futureWatcher->result();
+        // setRoots() dropped a root while the worker ran, its tree must not come back
+        if (delta.roots != m_index.roots) dropOutsideRoots(delta);
+        applyDelta(delta);
+        if (!m_ready) {
+            m_ready = true;
+            emit ready();
+        }
+        startNext();
+    }
+
+    void applyDelta(const Delta& delta) {
+        QStringList added, modified, removed;
+        for (const QString& dir : delta.removedDirs)
+            m_index.dirs.remove(dir);
+        for (auto it = delta.dirs.constBegin(); it != delta.dirs.constEnd(); ++it)
+            m_index.dirs.insert(it.key(), it.value());
+        for (const QString& path : delta.removedScripts) {
+            if (m_index.scripts.remove(path)) removed.append(path);
+        }
+        for (const ScriptInfo& info : delta.updated) {
+            (m_index.scripts.contains(info.path) ? modified : added).append(info.path);
+            m_index.scripts.insert(info.path, info);
+        }
+
+        if (delta.dirs.isEmpty() && delta.removedDirs.isEmpty() && delta.updated.isEmpty() && removed.isEmpty()) return;
+        m_dirty = true;
+        m_saveTimer->start();
+        updateWatcher();
+        if (!added.isEmpty() || !modified.isEmpty() || !removed.isEmpty())
+            emit catalogChanged(added, modified, removed);
+    }
+
+    bool isUnderRoots(const QString& path) const {
+        for (const QString& root : m_index.roots) {
+            if (path == root || path.startsWith(root.endsWith(QChar('/')) ? root : root + QChar('/'))) return true;
+        }
+        return false;
+    }
+
+    void dropOutsideRoots(Delta& delta) const {
+        for (auto it = delta.dirs.begin(); it != delta.dirs.end();) {
+            if (isUnderRoots(it.key())) ++it;
+            else it = delta.dirs.erase(it);
+        }
+        delta.updated.removeIf([this](const ScriptInfo& info) { return !isUnderRoots(info.path); });
+    }
+
+    void updateWatcher() {
+        const QStringList watched = m_watcher->directories();
+        const QSet<QString> current(watched.begin(), watched.end());
+        QStringList toAdd, toRemove;
+        for (auto it = m_index.dirs.constBegin(); it != m_index.dirs.constEnd(); ++it) {
+            if (!current.contains(it.key())) toAdd.append(it.key());
+        }
+        for (const QString& dir : watched) {
+            if (!m_index.dirs.contains(dir)) toRemove.append(dir);
+        }
+        if (!toRemove.isEmpty()) m_watcher->removePaths(toRemove);
+        if (!toAdd.isEmpty()) m_watcher->addPaths(toAdd);
+    }
+
+    /* Runs on a pool thread. Walks from 'startDirs' through the known tree with one stat per
+    directory, then lists the directories that are new, changed, 'forced' (or all with 'full')
+    through DirectoryScan, in parallel. New subdirectories are entered by the scan right away,
+    known ones go through the next stat pass. Finally the changed files are read.
+    */
+    static Delta revalidate(const Index& index, const QStringList& startDirs, const QSet<QString>& forced,
+                            const bool full, const general_util::DirectoryScanOptions& options) {
+        Delta delta;
+        delta.roots = index.roots;
+        QHash<QString, ScriptInfo> changed;
+        QSet<QString> visited;
+        QStringList check = startDirs;
+
+        while (!check.isEmpty()) {
+            QStringList toList;
+            QStringList stack = std::exchange(check, {});
+            while (!stack.isEmpty()) {
+                const QString dir = stack.takeLast();
+                if (visited.contains(dir)) continue;
+                visited.insert(dir);
+
+                const auto known = index.dirs.constFind(dir);
+                const bool isKnown = known != index.dirs.constEnd();
+                const QFileInfo dirInfo(dir);
+                if (!dirInfo.isDir()) {
+                    if (isKnown) removeTree(index, dir, delta);
+                    continue;
+                }
+                if (isKnown && !full && known->mtime == dirInfo.lastModified().toMSecsSinceEpoch() && !forced.contains(dir)) {
+                    stack.append(known->subdirs);
+                    continue;
+                }
+                toList.append(dir);
+            }
+            if (toList.isEmpty()) break;
+
+            QMutex mutex;
+            QList<general_util::DirectoryListing> listings;
+            general_util::DirectoryScan scan(options);
+            scan.setDescendFilter([&index](const QString& dir) { return !index.dirs.contains(dir); });
+            scan.setListingCallback([&mutex, &listings](const general_util::DirectoryListing& listing) {
+                QMutexLocker locker(&mutex);
+                listings.append(listing);
+            });
+            scan.start(toList, nullptr);
+            scan.wait();
+
+            for (const general_util::DirectoryListing& listing : std::as_const(listings)) {
+                visited.insert(listing.path);
+
+                Directory entry;
+                entry.mtime = listing.lastModified.toMSecsSinceEpoch();
+                entry.subdirs = listing.subdirs;
+                for (const QFileInfo& info : listing.files) {
+                    const QString path = info.filePath();
+                    const qint64 size = info.size();
+                    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+                    entry.scripts.append(path);
+
+                    const auto old = index.scripts.constFind(path);
+                    if (old == index.scripts.constEnd() || old->size != size || old->mtime != mtime) {
+                        ScriptInfo script;
+                        script.path = path;
+                        script.size = size;
+                        script.mtime = mtime;
+                        changed.insert(path, script);
+                    }
+                }
+
+                const auto known = index.dirs.constFind(listing.path);
+                if (known != index.dirs.constEnd()) {
+                    const QSet<QString> subdirs(entry.subdirs.begin(), entry.subdirs.end());
+                    const QSet<QString> scripts(entry.scripts.begin(), entry.scripts.end());
+                    for (const QString& subdir : known->subdirs) {
+                        if (!subdirs.contains(subdir)) removeTree(index, subdir, delta);
+                    }
+                    for (const QString& script : known->scripts) {
+                        if (!scripts.contains(script)) delta.removedScripts.append(script);
+                    }
+                }
+                // the scan did not enter known subdirectories, they get a stat in the next pass
+                for (const QString& subdir : std::as_const(entry.subdirs)) {
+                    if (index.dirs.contains(subdir)) check.append(subdir);
+                }
+                delta.dirs.insert(listing.path, std::move(entry));
+            }
+        }
+
+        // reading and parsing the changed files runs in parallel as well
+        delta.updated = QtConcurrent::blockingMapped<QList<ScriptInfo>>(changed.values(), &ScriptCatalog::readEntry);
+        return delta;
+    }
+
+    static ScriptInfo readEntry(const ScriptInfo& entry) {
+        return general_util::readScriptInfo(entry.path, entry.size, entry.mtime);
+    }
+
+    static void removeTree(const Index& index, const QString& dir, Delta& delta) {
+        delta.removedDirs.append(dir);
+        const auto known = index.dirs.constFind(dir);
+        if (known == index.dirs.constEnd()) return;
+        delta.removedScripts.append(known->scripts);
+        for (const QString& subdir : known->subdirs)
+            removeTree(index, subdir, delta);
+    }
+
+    static QByteArray toByteArray(const Index& index, const QString& signature) {
+        QByteArray bytes;
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << IndexMagic << IndexVersion << signature << index.roots;
+
+        out << qint32(index.dirs.count());
+        for (auto it = index.dirs.constBegin(); it != index.dirs.constEnd(); ++it)
+            out << it.key() << it->mtime << it->subdirs << it->scripts;
+
+        out << qint32(index.scripts.count());
+        for (const ScriptInfo& info : index.scripts)
+            out << info.path << info.size << info.mtime << info.docstring << info.entryPoints;
+        return bytes;
+    }
+
+    static bool fromByteArray(const QByteArray& bytes, const QString& signature, Index& index) {
+        QDataStream in(bytes);
+        in.setVersion(QDataStream::Qt_6_0);
+
+        quint32 magic = 0;
+        quint8 version = 0;
+        QString storedSignature;
+        in >> magic >> version;
+        if (in.status() != QDataStream::Ok || magic != IndexMagic || version != IndexVersion) return false;
+        in >> storedSignature >> index.roots;
+        // different filters make the stored tree meaningless
+        if (in.status() != QDataStream::Ok || storedSignature != signature) return false;
+
+        qint32 dirCount = 0;
+        in >> dirCount;
+        // the counts come from the file, a corrupt one must not reserve gigabytes
+        for (qint32 i = 0; i < dirCount && in.status() == QDataStream::Ok; ++i) {
+            QString path;
+            Directory dir;
+            in >> path >> dir.mtime >> dir.subdirs >> dir.scripts;
+            index.dirs.insert(path, dir);
+        }
+
+        qint32 scriptCount = 0;
+        in >> scriptCount;
+        for (qint32 i = 0; i < scriptCount && in.status() == QDataStream::Ok; ++i) {
+            ScriptInfo info;
+            in >> info.path >> info.size >> info.mtime >> info.docstring >> info.entryPoints;
+            index.scripts.insert(info.path, info);
+        }
+        return in.status() == QDataStream::Ok;
+    }
+
+};
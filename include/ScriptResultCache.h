@@ -0,0 +1,476 @@
+#pragma once
+#include <optional>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QFutureWatcher>
+#include <QCryptographicHash>
+#include "ProcessScheduler.h"
+
+
+/* Everything that decides the result of a script run, and what to keep of it.
+*/
+struct ScriptRunSpec
+{
+    QString script;
+    QStringList arguments;
+    QString workingDirectory;
+    QString python = "python";
+    QStringList pyPaths;
+    QStringList environmentKeys;    // variables that affect the result, e.g. {"PYTHONPATH", "RENDER_QUALITY"}
+    QStringList inputFiles;         // files read by the script, their contents are part of the key
+    QStringList outputFiles;        // artifacts written by the script, stored and restored with the result
+    int timeoutMs = 0;
+    int priority = 0;
+};
+
+
+struct ScriptRunResult
+{
+    qint64 id = -1;
+    QString key;                    // hex SHA-256, empty when the run could not be keyed
+    ProcessJobResult::Status status = ProcessJobResult::Finished;
+    int exitCode = -1;
+    QByteArray output;
+    bool fromCache = false;
+
+    bool ok() const { return status == ProcessJobResult::Finished && exitCode == 0; }
+};
+
+
+namespace general_util {
+
+    /* On-disk, content-addressed store of script results.
+    An entry lives in <root>/<key[0..1]>/<key>/ with meta.json, the captured output and the
+    artifacts. Entries are written to a temporary directory and renamed into place, so a crash
+    never leaves a half-written entry. The total size is bounded, least recently used entries
+    are evicted first. All methods are thread-safe.
+
+    File contents are hashed once per (path, size, mtime), like ccache/make do,
+    so unchanged inputs are not re-read on every lookup.
+    */
+    class ScriptResultCache
+    {
+    public:
+        struct Entry {
+            int exitCode = 0;
+            QByteArray output;
+        };
+
+    private:
+        struct IndexEntry {
+            qint64 size = 0;
+            qint64 lastAccess = 0;
+        };
+
+        struct FileHash {
+            qint64 size = -1;
+            qint64 mtime = 0;
+            QByteArray hash;
+        };
+
+        const QString m_root;
+        qint64 m_maxBytes = 0;
+
+        mutable QMutex m_mutex;
+        QHash<QString, IndexEntry> m_index;
+        qint64 m_totalBytes = 0;
+        bool m_indexLoaded = false;
+
+        mutable QMutex m_hashMutex;
+        mutable QHash<QString, FileHash> m_fileHashes;
+
+    public:
+        explicit ScriptResultCache(const QString& root, const qint64 maxBytes = qint64(2) * 1024 * 1024 * 1024)
+            : m_root(root), m_maxBytes(qMax<qint64>(1024 * 1024, maxBytes)) {}
+
+        QString root() const { return m_root; }
+
+        qint64 maxBytes() const {
+            QMutexLocker locker(&m_mutex);
+            return m_maxBytes;
+        }
+        void setMaxBytes(const qint64 bytes) {
+            QMutexLocker locker(&m_mutex);
+            m_maxBytes = qMax<qint64>(1024 * 1024, bytes);
+            loadIndex();
+            evict();
+        }
+
+        qint64 totalBytes() const {
+            QMutexLocker locker(&m_mutex);
+            return m_totalBytes;
+        }
+
+        /* Hex SHA-256 over the script contents, arguments, interpreter, selected environment,
+        input file contents and the declared outputs. Relative paths are taken from the working
+        directory, like the run itself does. Empty (the run is not cached) when the script or a
+        declared input can not be read.
+        */
+        QString computeKey(const ScriptRunSpec& spec) const {
+            const QByteArray scriptHash = hashFile(resolve(spec.script, spec.workingDirectory));
+            if (scriptHash.isEmpty()) return QString();
+
+            QCryptographicHash hash(QCryptographicHash::Sha256);
+            auto add = [&hash](const char* tag, const QByteArray& value) {
+                const quint64 length = quint64(value.size());
+                hash.addData(QByteArrayView(tag));
+                hash.addData(QByteArrayView(reinterpret_cast<const char*>(&length), sizeof(length)));
+                hash.addData(value);
+            };
+
+            add("version", "1");
+            add("python", spec.python.toUtf8());
+            add("script", scriptHash);
+            add("cwd", spec.workingDirectory.toUtf8());
+            for (const QString& arg : spec.arguments)
+                add("arg", arg.toUtf8());
+
+            const QProcessEnvironment env = pythonEnvironment(spec.pyPaths);
+            QStringList keys = spec.environmentKeys;
+            keys.sort();
+            for (const QString& key : keys)
+                add("env", (key + '=' + env.value(key)).toUtf8());
+
+            for (const QString& input : spec.inputFiles) {
+                const QByteArray inputHash = hashFile(resolve(input, spec.workingDirectory));
+                if (inputHash.isEmpty()) return QString();
+                add("input", input.toUtf8());
+                add("content", inputHash);
+            }
+            for (const QString& output : spec.outputFiles)
+                add("output", output.toUtf8());
+
+            return QString::fromLatin1(hash.result().toHex());
+        }
+
+        bool contains(const QString& key) {
+            QMutexLocker locker(&m_mutex);
+            loadIndex();
+            return m_index.contains(key);
+        }
+
+        /* Look 'key' up and copy its artifacts back to 'outputFiles' (relative to 'workingDirectory').
+        */
+        std::optional<Entry> lookup(const QString& key, const QStringList& outputFiles = {},
+                                    const QString& workingDirectory = QString()) {
+            {
+                QMutexLocker locker(&m_mutex);
+                loadIndex();
+                if (!m_index.contains(key)) return std::nullopt;
+            }
+
+            const QString dir = entryPath(key);
+            QFile metaFile(dir + "/meta.json");
+            QFile outputFile(dir + "/output.bin");
+            if (!metaFile.open(QIODevice::ReadOnly) || !outputFile.open(QIODevice::ReadOnly)) {
+                remove(key);
+                return std::nullopt;
+            }
+
+            const QJsonObject meta = QJsonDocument::fromJson(metaFile.readAll()).object();
+            Entry entry;
+            entry.exitCode = meta.value("exitCode").toInt();
+            entry.output = outputFile.readAll();
+
+            for (int i = 0; i < outputFiles.count(); ++i) {
+                const QString target = resolve(outputFiles.at(i), workingDirectory);
+                QDir().mkpath(QFileInfo(target).absolutePath());
+                QFile::remove(target);
+                if (!QFile::copy(dir + QString("/artifact-%1").arg(i), target)) {
+                    remove(key);
+                    return std::nullopt;
+                }
+            }
+
+            // remember the access, the entry directory's meta.json mtime survives restarts
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            metaFile.close();
+            if (metaFile.open(QIODevice::ReadWrite))
+                metaFile.setFileTime(QDateTime::fromMSecsSinceEpoch(now), QFileDevice::FileModificationTime);
+
+            QMutexLocker locker(&m_mutex);
+            if (m_index.contains(key)) m_index[key].lastAccess = now;
+            return entry;
+        }
+
+        /* Store a result with the artifacts 'outputFiles' (relative to 'workingDirectory').
+        */
+        bool store(const QString& key, const Entry& entry, const QStringList& outputFiles = {},
+                   const QString& workingDirectory = QString()) {
+            if (key.isEmpty()) return false;
+
+            const QString tmp = m_root + "/tmp-" + key + "-" + QString::number(QDateTime::currentMSecsSinceEpoch());
+            if (!QDir().mkpath(tmp)) return false;
+
+            qint64 size = 0;
+            bool ok = true;
+
+            QFile outputFile(tmp + "/output.bin");
+            ok = ok && outputFile.open(QIODevice::WriteOnly) && outputFile.write(entry.output) == entry.output.size();
+            outputFile.close();
+            size += entry.output.size();
+
+            QJsonArray outputs;
+            for (int i = 0; ok && i < outputFiles.count(); ++i) {
+                const QString source = resolve(outputFiles.at(i), workingDirectory);
+                ok = QFile::copy(source, tmp + QString("/artifact-%1").arg(i));
+                size += QFileInfo(source).size();
+                outputs.append(outputFiles.at(i));
+            }
+
+            QJsonObject meta;
+            meta.insert("exitCode", entry.exitCode);
+            meta.insert("size", size);
+            meta.insert("outputs", outputs);
+            meta.insert("created", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+            QFile metaFile(tmp + "/meta.json");
+            ok = ok && metaFile.open(QIODevice::WriteOnly) && metaFile.write(QJsonDocument(meta).toJson()) > 0;
+            metaFile.close();
+
+            const QString dir = entryPath(key);
+            QDir().mkpath(QFileInfo(dir).absolutePath());
+            // another run may have stored the same key meanwhile, both are equivalent
+            if (!ok || QFileInfo::exists(dir) || !QDir().rename(tmp, dir)) {
+                QDir(tmp).removeRecursively();
+                return ok && QFileInfo::exists(dir);
+            }
+
+            QMutexLocker locker(&m_mutex);
+            loadIndex();
+            m_totalBytes += size - m_index.value(key).size;
+            m_index.insert(key, {size, QDateTime::currentMSecsSinceEpoch()});
+            evict();
+            return true;
+        }
+
+        void remove(const QString& key) {
+            QMutexLocker locker(&m_mutex);
+            removeLocked(key);
+        }
+
+        void clear() {
+            QMutexLocker locker(&m_mutex);
+            QDir(m_root).removeRecursively();
+            m_index.clear();
+            m_totalBytes = 0;
+            m_indexLoaded = true;
+        }
+
+        QString entryPath(const QString& key) const {
+            return m_root + "/" + key.left(2) + "/" + key;
+        }
+
+    private:
+        static QString resolve(const QString& path, const QString& workingDirectory) {
+            if (workingDirectory.isEmpty() || QFileInfo(path).isAbsolute()) return path;
+            return QDir(workingDirectory).filePath(path);
+        }
+
+        QByteArray hashFile(const QString& path) const {
+            const QFileInfo info(path);
+            if (!info.isFile()) return QByteArray();
+            const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+            const QString absPath = info.absoluteFilePath();
+            {
+                QMutexLocker locker(&m_hashMutex);
+                auto it = m_fileHashes.constFind(absPath);
+                if (it != m_fileHashes.constEnd() && it->size == info.size() && it->mtime == mtime)
+                    return it->hash;
+            }
+
+            QFile file(absPath);
+            if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+            QCryptographicHash hash(QCryptographicHash::Sha256);
+            hash.addData(&file);
+            const QByteArray result = hash.result();
+
+            QMutexLocker locker(&m_hashMutex);
+            m_fileHashes.insert(absPath, {info.size(), mtime, result});
+            return result;
+        }
+
+        // m_mutex held
+        void loadIndex() {
+            if (m_indexLoaded) return;
+            m_indexLoaded = true;
+
+            const QStringList buckets = QDir(m_root).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            for (const QString& bucket : buckets) {
+                if (bucket.startsWith("tmp-")) {
+                    // left over by a crash, a recent one may still be written by another thread
+                    const QFileInfo info(m_root + "/" + bucket);
+                    if (info.lastModified().secsTo(QDateTime::currentDateTime()) > 3600)
+                        QDir(info.filePath()).removeRecursively();
+                    continue;
+                }
+                const QStringList keys = QDir(m_root + "/" + bucket).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+                for (const QString& key : keys) {
+                    QFile metaFile(entryPath(key) + "/meta.json");
+                    if (!metaFile.open(QIODevice::ReadOnly)) continue;
+                    const qint64 size = QJsonDocument::fromJson(metaFile.readAll()).object().value("size").toInteger();
+                    const qint64 lastAccess = QFileInfo(metaFile).lastModified().toMSecsSinceEpoch();
+                    m_index.insert(key, {size, lastAccess});
+                    m_totalBytes += size;
+                }
+            }
+        }
+
+        // m_mutex held, drop the least recently used entries down to 90% of the limit
+        void evict() {
+            if (m_totalBytes <= m_maxBytes) return;
+
+            QVector<QPair<qint64, QString>> byAccess;
+            byAccess.reserve(m_index.count());
+            for (auto it = m_index.cbegin(); it != m_index.cend(); ++it)
+                byAccess.append({it->lastAccess, it.key()});
+            std::sort(byAccess.begin(), byAccess.end());
+
+            const qint64 target = m_maxBytes / 10 * 9;
+            for (const auto& item : byAccess) {
+                if (m_totalBytes <= target) break;
+                removeLocked(item.second);
+            }
+        }
+
+        void removeLocked(const QString& key) {
+            if (!m_index.contains(key)) return;
+            m_totalBytes -= m_index.take(key).size;
+            QDir(entryPath(key)).removeRecursively();
+        }
+    };
+
+}   // namespace general_util
+
+
+/* Runs scripts through a ProcessScheduler, answering from a ScriptResultCache when possible.
+Keys are computed and cached results restored on a worker thread; a hit never spawns
+a process. Only successful runs (exit code 0) are stored; their artifacts are copied into
+the cache on a worker thread, and finished() is only emitted once that copy is done.
+
+Example usage:
+    general_util::ScriptResultCache cache(general_util::userDocPath() + "/.script_cache");
+    CachedScriptRunner* runner = new CachedScriptRunner(&cache, scheduler, this);
+    connect(runner, &CachedScriptRunner::finished, this, [](const ScriptRunResult& result) {
+        qDebug() << result.id << result.fromCache << result.exitCode;
+    });
+
+    ScriptRunSpec spec;
+    spec.script = general_util::getPythonScriptPath() + "/bake.py";
+    spec.arguments = {"--frame", "12"};
+    spec.inputFiles = {"scene.usd"};
+    spec.outputFiles = {"bake/frame12.exr"};
+    runner->run(spec);
+*/
+class CachedScriptRunner : public QObject
+{
+Q_OBJECT
+
+signals:
+    void finished(const ScriptRunResult& result);
+
+private:
+    struct Run {
+        qint64 id = -1;
+        ScriptRunSpec spec;
+        QString key;
+    };
+
+    general_util::ScriptResultCache* m_cache = nullptr;
+    ProcessScheduler* m_scheduler = nullptr;
+    QHash<qint64, Run> m_runs;          // by scheduler job id
+    qint64 m_nextId = 1;
+    bool m_enabled = true;
+
+public:
+    CachedScriptRunner(general_util::ScriptResultCache* cache, ProcessScheduler* scheduler, QObject* parent = nullptr)
+        : QObject(parent), m_cache(cache), m_scheduler(scheduler) {
+        connect(m_scheduler, &ProcessScheduler::jobFinished, this, &CachedScriptRunner::on_jobFinished);
+    }
+
+    // with the cache disabled every run spawns a process and nothing is stored
+    bool isCacheEnabled() const { return m_enabled; }
+    void setCacheEnabled(const bool enabled) { m_enabled = enabled; }
+
+    /* Run 'spec', the result arrives through finished() with the returned id.
+    */
+    qint64 run(const ScriptRunSpec& spec) {
+        const qint64 id = m_nextId ++;
+        if (!m_enabled) {
+            submit(id, spec, QString());
+            return id;
+        }
+
+        using Lookup = QPair<QString, std::optional<general_util::ScriptResultCache::Entry>>;
+        general_util::ScriptResultCache* cache = m_cache;
+        QFutureWatcher<Lookup>* watcher = new QFutureWatcher<Lookup>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, id, spec]() {
+            const Lookup lookup = watcher->result();
+            watcher->deleteLater();
+            if (!lookup.second) {
+                submit(id, spec, lookup.first);
+                return;
+            }
+            ScriptRunResult result;
+            result.id = id;
+            result.key = lookup.first;
+            result.exitCode = lookup.second->exitCode;
+            result.output = lookup.second->output;
+            result.fromCache = true;
+            emit finished(result);
+        });
+        watcher->setFuture(QtConcurrent::run([cache, spec]() {
+            const QString key = cache->computeKey(spec);
+            if (key.isEmpty()) return Lookup(key, std::nullopt);
+            return Lookup(key, cache->lookup(key, spec.outputFiles, spec.workingDirectory));
+        }));
+        return id;
+    }
+
+private:
+    void submit(const qint64 id, const ScriptRunSpec& spec, const QString& key) {
+        ProcessJob job;
+        job.program = spec.python;
+        job.arguments = QStringList{spec.script} + spec.arguments;
+        job.workingDirectory = spec.workingDirectory;
+        job.pyPaths = spec.pyPaths;
+        job.timeoutMs = spec.timeoutMs;
+        job.priority = spec.priority;
+
+        m_runs.insert(m_scheduler->submit(job), {id, spec, key});
+    }
+
+    void on_jobFinished(const ProcessJobResult& jobResult) {
+        if (!m_runs.contains(jobResult.id)) return;
+        const Run run = m_runs.take(jobResult.id);
+
+        ScriptRunResult result;
+        result.id = run.id;
+        result.key = run.key;
+        result.status = jobResult.status;
+        result.exitCode = jobResult.exitCode;
+        result.output = jobResult.output;
+
+        if (!m_enabled || !result.ok() || run.key.isEmpty()) {
+            emit finished(result);
+            return;
+        }
+
+        // whoever reacts to finished() may rewrite the artifacts, they have to be in the cache by then
+        general_util::ScriptResultCache* cache = m_cache;
+        const general_util::ScriptResultCache::Entry entry {result.exitCode, result.output};
+        QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, result]() {
+            watcher->deleteLater();
+            emit finished(result);
+        });
+        watcher->setFuture(QtConcurrent::run([cache, run, entry]() {
+            return cache->store(run.key, entry, run.spec.outputFiles, run.spec.workingDirectory);
+        }));
+    }
+
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <QWidget>
+#include <QVariant>
 #include <QComboBox>
 #include <QPushButton>
 
@@ -18,6 +19,12 @@ public:
 
     virtual ~OverrideFieldWidgetBase() {}
 
+    virtual QString getName() const { return QString(); }
+
+    // generic access to the field value, used by OverrideGroup presets
+    virtual QVariant getFieldValue() const { return QVariant(); }
+    virtual bool setFieldValue(const QVariant& value) { return false; }
+
     bool isOverride() const {
         return m_override;
     }
@@ -39,6 +46,7 @@ class MessageBoxBase : public QWidget
 signals:
     void buttonClicked(QPushButton* btn);
     void showRequested();
+    void closed();
 
 public:
     explicit MessageBoxBase(QWidget* parent = nullptr, const QString& title = "", const QString& msg = "")
@@ -56,6 +64,7 @@ class ComboBoxBase : public QComboBox {
     Q_OBJECT
 signals:
     void popuped();
+    void itemsLoaded();
 
 public:
     explicit ComboBoxBase(QWidget* parent = nullptr) : QComboBox(parent) {};
@@ -1,53 +1,109 @@
 ﻿#pragma once
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <functional>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
 #include <QDir>
 #include <QFile>
 #include <QMenu>
 #include <QStyle>
 #include <QLabel>
 #include <QTimer>
+#include <QMutex>
+#include <QUrl>
+#include <QLocale>
+#include <QFuture>
+#include <QPromise>
 #include <QWidget>
+#include <QPointer>
+#include <QPainter>
 #include <QPalette>
+#include <QSlider>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QListView>
+#include <QCompleter>
+#include <QLineEdit>
 #include <QTextEdit>
+#include <QScrollBar>
 #include <QStatusBar>
+#include <QProgressBar>
+#include <QElapsedTimer>
 #include <QTextStream>
 #include <QPushButton>
+#include <QToolButton>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QMessageBox>
+#include <QProxyStyle>
+#include <QMetaProperty>
+#include <QFutureWatcher>
+#include <QStringListModel>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDoubleSpinBox>
+#include <QAbstractButton>
+#include <QApplication>
+#include <QGuiApplication>
+#include <QRegularExpression>
+#include <QStyleOption>
 #include <QDirIterator>
+#include <QStyleFactory>
 #include <QStandardPaths>
+#include <QDesktopServices>
 #include <QCoreApplication>
 #include <QProcessEnvironment>
 
 #include "utilWidgetsBases.h"
+#include "LogView.h"
+#include "EnvironmentBuilder.h"
+#include "DirectoryScanner.h"
+#include "FileReader.h"
 
 
 namespace utilWidgets {
 
     inline QPalette darkModePalete() {
-        QPalette palette;
-
-        palette.setColor(QPalette::Window, QColor(53, 53, 53));
-        palette.setColor(QPalette::WindowText, Qt::white);
-        palette.setColor(QPalette::Base, QColor(42, 42, 42));
-        palette.setColor(QPalette::AlternateBase, QColor(66, 66, 66));
-        palette.setColor(QPalette::ToolTipBase, Qt::white);
-        palette.setColor(QPalette::ToolTipText, Qt::white);
-        palette.setColor(QPalette::Text, Qt::white);
-        palette.setColor(QPalette::Button, QColor(53, 53, 53));
-        palette.setColor(QPalette::ButtonText, Qt::white);
-        palette.setColor(QPalette::BrightText, Qt::red);
-
-        palette.setColor(QPalette::Highlight, QColor(142, 45, 197));
-        palette.setColor(QPalette::HighlightedText, Qt::green);
-
-        palette.setColor(QPalette::Light, QColor(70,70,70));
-        palette.setColor(QPalette::Mid, QColor(30,30,30));
-        palette.setColor(QPalette::Dark, QColor(20,20,20));
-        palette.setColor(QPalette::Shadow, Qt::black);
-
-        return palette;
+        // built once, copies are implicitly shared
+        static const QPalette cached = []() {
+            QPalette palette;
+
+            palette.setColor(QPalette::Window, QColor(53, 53, 53));
+            palette.setColor(QPalette::WindowText, Qt::white);
+            palette.setColor(QPalette::Base, QColor(42, 42, 42));
+            palette.setColor(QPalette::AlternateBase, QColor(66, 66, 66));
+            palette.setColor(QPalette::ToolTipBase, Qt::white);
+            palette.setColor(QPalette::ToolTipText, Qt::white);
+            palette.setColor(QPalette::Text, Qt::white);
+            palette.setColor(QPalette::Button, QColor(53, 53, 53));
+            palette.setColor(QPalette::ButtonText, Qt::white);
+            palette.setColor(QPalette::BrightText, Qt::red);
+
+            palette.setColor(QPalette::Highlight, QColor(142, 45, 197));
+            palette.setColor(QPalette::HighlightedText, Qt::green);
+
+            palette.setColor(QPalette::Light, QColor(70,70,70));
+            palette.setColor(QPalette::Mid, QColor(30,30,30));
+            palette.setColor(QPalette::Dark, QColor(20,20,20));
+            palette.setColor(QPalette::Shadow, Qt::black);
+
+            // disabled labels, buttons, editors and combo boxes
+            palette.setColor(QPalette::Disabled, QPalette::WindowText, QColor("#777777"));
+            palette.setColor(QPalette::Disabled, QPalette::Text, QColor("#777777"));
+            palette.setColor(QPalette::Disabled, QPalette::ButtonText, QColor("#777777"));
+            palette.setColor(QPalette::Disabled, QPalette::Base, QColor("#2a2a2a"));
+            palette.setColor(QPalette::Disabled, QPalette::Button, QColor("#2a2a2a"));
+
+            return palette;
+        }();
+        return cached;
     }
 
     inline QString darkModeStyleSheet = R"(
@@ -184,8 +240,300 @@ namespace utilWidgets {
         }
     )";
 
+    /* Native counterpart of darkModeStyleSheet.
+    Paints buttons, tool buttons, line edits, combo boxes, text edit frames and scroll bars
+    in the dark look through a QProxyStyle,
+    so widgets skip QStyleSheetStyle parsing, polish and painting entirely.
+    Install it once for the whole application with setDarkTheme().
+    */
+    class DarkStyle : public QProxyStyle
+    {
+    private:
+        bool m_enabled = true;
+        QString m_platformStyleName;
+
+    public:
+        // object names selecting a variant, for widgets that used to bring their own style sheet
+        static constexpr const char* AccentFrameName = "darkAccentFrame";       // 2px accent border
+        static constexpr const char* HeavyButtonName = "darkHeavyButton";       // 2px border, no focus ring
+
+        explicit DarkStyle(const QString& platformStyleName = QString())
+            : QProxyStyle(QStyleFactory::create("Fusion")), m_platformStyleName(platformStyleName) {}
+        ~DarkStyle() override = default;
+
+        bool isEnabled() const { return m_enabled; }
+
+        /* Switch between the dark look (Fusion based) and the platform style.
+        The caller is responsible for repolishing, see setDarkTheme().
+        */
+        void setEnabled(const bool enabled) {
+            if (m_enabled == enabled) return;
+            m_enabled = enabled;
+
+            QStyle* base = QStyleFactory::create(enabled ? "Fusion" : m_platformStyleName);
+            setBaseStyle(base ? base : QStyleFactory::create("Fusion"));
+        }
+
+        using QProxyStyle::polish;
+
+        QPalette standardPalette() const override {
+            return m_enabled ? darkModePalete() : QProxyStyle::standardPalette();
+        }
+
+        void polish(QPalette& palette) override {
+            if (m_enabled) {
+                palette = darkModePalete();
+                return;
+            }
+            QProxyStyle::polish(palette);
+        }
+
+        void polish(QWidget* widget) override {
+            QProxyStyle::polish(widget);
+            if (m_enabled && (qobject_cast<QAbstractButton*>(widget) || qobject_cast<QScrollBar*>(widget)
+                              || qobject_cast<QComboBox*>(widget))) {
+                widget->setAttribute(Qt::WA_Hover, true);
+            }
+        }
+
+        int pixelMetric(PixelMetric metric, const QStyleOption* opt = nullptr, const QWidget* widget = nullptr) const override {
+            if (m_enabled) {
+                switch (metric) {
+                case PM_ScrollBarExtent: return 12;
+                case PM_ScrollBarSliderMin: return 20;
+                case PM_DefaultFrameWidth:
+                    if (widget && widget->objectName() == QLatin1String(AccentFrameName)) return 2;
+                    break;
+                default: break;
+                }
+            }
+            return QProxyStyle::pixelMetric(metric, opt, widget);
+        }
+
+        void drawPrimitive(PrimitiveElement element, const QStyleOption* opt,
+                           QPainter* painter, const QWidget* widget = nullptr) const override {
+            if (!m_enabled) {
+                QProxyStyle::drawPrimitive(element, opt, painter, widget);
+                return;
+            }
+
+            const bool enabled = opt->state & State_Enabled;
+            const bool hasFocus = opt->state & State_HasFocus;
+
+            switch (element) {
+            case PE_FrameFocusRect:
+                // focus is drawn as a colored border instead
+                return;
+
+            case PE_PanelButtonCommand: {
+                const bool hovered = opt->state & State_MouseOver;
+                const bool pressed = opt->state & (State_Sunken | State_On);
+
+                if (widget && widget->objectName() == QLatin1String(HeavyButtonName)) {
+                    drawRoundedPanel(painter, opt->rect, QColor(hovered ? "#4c5052" : "#3c3f41"), QColor("#555555"), 2, 4);
+                    return;
+                }
+
+                QColor bg("#3c3f41");
+                QColor border("#5a5a5a");
+                int borderWidth = 1;
+                if (!enabled) {
+                    bg = QColor("#2a2a2a");
+                    border = QColor("#444444");
+                } else if (pressed) {
+                    bg = QColor("#2c2f31");
+                } else if (hovered) {
+                    bg = QColor("#4c5052");
+                    border = QColor("#6a6a6a");
+                }
+                if (enabled && hasFocus) {
+                    border = QColor("#8e2dc5");
+                    borderWidth = 2;
+                }
+                drawRoundedPanel(painter, opt->rect, bg, border, borderWidth, 3);
+                return;
+            }
+
+            case PE_PanelLineEdit: {
+                QColor bg = !enabled ? QColor("#2a2a2a") : (hasFocus ? QColor("#444444") : QColor("#3c3f41"));
+                QColor border = !enabled ? QColor("#444444") : (hasFocus ? QColor("#8e2dc5") : QColor("#5a5a5a"));
+
+                const auto* frame = qstyleoption_cast<const QStyleOptionFrame*>(opt);
+                if (frame && frame->lineWidth <= 0) {
+                    // frameless editor, e.g. inside a spin box or an editable combo box
+                    painter->fillRect(opt->rect, bg);
+                    return;
+                }
+                drawRoundedPanel(painter, opt->rect, bg, border, 1, 3);
+                return;
+            }
+
+            case PE_PanelButtonTool: {
+                // flat until hovered
+                const bool hovered = opt->state & State_MouseOver;
+                const bool pressed = opt->state & (State_Sunken | State_On);
+                if (!enabled || (!hovered && !pressed)) return;
+                drawRoundedPanel(painter, opt->rect, pressed ? QColor("#2c2f31") : QColor("#444444"), QColor("#888888"), 1, 3);
+                return;
+            }
+
+            case PE_Frame:
+                if (widget && widget->objectName() == QLatin1String(AccentFrameName)) {
+                    drawRoundedPanel(painter, opt->rect, Qt::transparent, QColor("#8e2dc5"), 2, 5);
+                    return;
+                }
+                if (qobject_cast<const QTextEdit*>(widget)) {
+                    // the viewport paints the Base color inside
+                    drawRoundedPanel(painter, opt->rect, Qt::transparent, enabled ? QColor("#5a5a5a") : QColor("#444444"), 1, 4);
+                    return;
+                }
+                break;
+
+            default:
+                break;
+            }
+            QProxyStyle::drawPrimitive(element, opt, painter, widget);
+        }
+
+        void drawComplexControl(ComplexControl control, const QStyleOptionComplex* opt,
+                                QPainter* painter, const QWidget* widget = nullptr) const override {
+            if (m_enabled && control == CC_ComboBox) {
+                if (const auto* combo = qstyleoption_cast<const QStyleOptionComboBox*>(opt)) {
+                    const bool enabled = combo->state & State_Enabled;
+                    const bool hovered = combo->state & State_MouseOver;
+                    const bool hasFocus = combo->state & State_HasFocus;
+
+                    QColor bg = !enabled ? QColor("#2a2a2a") : (hovered ? QColor("#4c5052") : QColor("#3c3f41"));
+                    QColor border = !enabled ? QColor("#444444") : (hasFocus ? QColor("#8e2dc5") : QColor("#5a5a5a"));
+                    drawRoundedPanel(painter, combo->rect, bg, border, 1, 3);
+
+                    // an editable combo box paints its line edit itself
+                    QStyleOption arrow = *combo;
+                    arrow.rect = subControlRect(CC_ComboBox, combo, SC_ComboBoxArrow, widget);
+                    drawPrimitive(PE_IndicatorArrowDown, &arrow, painter, widget);
+                    return;
+                }
+            }
+            if (m_enabled && control == CC_ScrollBar) {
+                if (const auto* bar = qstyleoption_cast<const QStyleOptionSlider*>(opt)) {
+                    painter->fillRect(bar->rect, QColor("#2b2b2b"));
+
+                    QRect handle = scrollBarRect(bar, SC_ScrollBarSlider);
+                    if (handle.isValid()) {
+                        const bool hovered = (bar->state & State_MouseOver)
+                                             && (bar->activeSubControls & SC_ScrollBarSlider);
+                        painter->save();
+                        painter->setRenderHint(QPainter::Antialiasing, true);
+                        painter->setPen(Qt::NoPen);
+                        painter->setBrush(hovered ? QColor("#787878") : QColor("#5a5a5a"));
+                        painter->drawRoundedRect(handle.adjusted(2, 2, -2, -2), 4, 4);
+                        painter->restore();
+                    }
+                    return;
+                }
+            }
+            QProxyStyle::drawComplexControl(control, opt, painter, widget);
+        }
+
+        QRect subControlRect(ComplexControl control, const QStyleOptionComplex* opt,
+                             SubControl subControl, const QWidget* widget = nullptr) const override {
+            if (m_enabled && control == CC_ScrollBar) {
+                if (const auto* bar = qstyleoption_cast<const QStyleOptionSlider*>(opt)) {
+                    return scrollBarRect(bar, subControl);
+                }
+            }
+            return QProxyStyle::subControlRect(control, opt, subControl, widget);
+        }
+
+    private:
+        static void drawRoundedPanel(QPainter* painter, const QRect& rect, const QColor& bg,
+                                     const QColor& border, int borderWidth, qreal radius) {
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing, true);
+            painter->setPen(QPen(border, borderWidth));
+            painter->setBrush(bg);
+            const qreal inset = borderWidth / 2.0;
+            painter->drawRoundedRect(QRectF(rect).adjusted(inset, inset, -inset, -inset), radius, radius);
+            painter->restore();
+        }
+
+        // scroll bars without arrow buttons, the slider uses the whole groove
+        QRect scrollBarRect(const QStyleOptionSlider* bar, SubControl subControl) const {
+            const bool horizontal = bar->orientation == Qt::Horizontal;
+            const QRect& rect = bar->rect;
+            const int length = horizontal ? rect.width() : rect.height();
+            const int range = bar->maximum - bar->minimum;
+
+            int sliderLength = length;
+            if (range > 0) {
+                sliderLength = static_cast<int>(qint64(length) * bar->pageStep / (qint64(range) + bar->pageStep));
+                sliderLength = qBound(qMin(20, length), sliderLength, length);
+            }
+            const int sliderStart = range > 0
+                ? sliderPositionFromValue(bar->minimum, bar->maximum, bar->sliderPosition,
+                                          length - sliderLength, bar->upsideDown)
+                : 0;
+
+            auto span = [&](int start, int size) {
+                return horizontal ? QRect(rect.x() + start, rect.y(), size, rect.height())
+                                  : QRect(rect.x(), rect.y() + start, rect.width(), size);
+            };
+
+            switch (subControl) {
+            case SC_ScrollBarSlider: return span(sliderStart, sliderLength);
+            case SC_ScrollBarSubPage: return span(0, sliderStart);
+            case SC_ScrollBarAddPage: return span(sliderStart + sliderLength, length - sliderStart - sliderLength);
+            case SC_ScrollBarGroove: return rect;
+            default: return QRect();
+            }
+        }
+    };
+
+    inline QPointer<DarkStyle>& darkStyleInstance() {
+        static QPointer<DarkStyle> style;
+        return style;
+    }
+
+    inline bool isDarkThemeEnabled() {
+        const QPointer<DarkStyle>& style = darkStyleInstance();
+        return style && style->isEnabled() && QApplication::style() == style.data();
+    }
+
+    /* Install (once) or toggle the application-wide dark theme.
+    The style and palette are shared by every widget, switching at runtime
+    costs a single repolish pass over the existing widgets.
+
+    Example usage:
+        QApplication app(argc, argv);
+        utilWidgets::setDarkTheme(true);
+    */
+    inline void setDarkTheme(const bool enabled) {
+        QPointer<DarkStyle>& style = darkStyleInstance();
+        if (!style || QApplication::style() != style.data()) {
+            if (!enabled) return;
+            style = new DarkStyle(QApplication::style()->name());
+            QApplication::setStyle(style);  // the application takes ownership and repolishes
+            QApplication::setPalette(style->standardPalette());
+            return;
+        }
+        if (style->isEnabled() == enabled) return;
+
+        // the base style that polished the widgets unpolishes them, before it is replaced
+        const QWidgetList widgets = QApplication::allWidgets();
+        for (QWidget* widget : widgets)
+            style->unpolish(widget);
+        style->setEnabled(enabled);
+        for (QWidget* widget : widgets)
+            style->polish(widget);
+        QApplication::setPalette(style->standardPalette());
+    }
+
+    /* Apply the dark palette and style sheet to a single widget.
+    Does nothing once the application-wide theme is active, see setDarkTheme().
+    */
     template <typename T>
     inline void applyDarkMode(T& t) {
+        if (isDarkThemeEnabled()) return;
         t.setPalette(darkModePalete());
         t.setStyleSheet(darkModeStyleSheet);
     }
@@ -211,7 +559,216 @@ namespace utilWidgets {
     };
 
 
-    using ComboBox = ComboBoxBase;
+    /* ComboBoxBase with optional lazy, asynchronous population and type-ahead filtering.
+    The popup is a uniform-item-size QListView, so it opens quickly even with 100k entries.
+
+    Example usage:
+        auto* combo = new utilWidgets::ComboBox(this);
+        combo->setLazyProvider([]() { return listAssetNames(); });   // runs on a worker thread when popped
+        combo->setFilterEnabled(true);                                // substring filtering while typing
+    */
+    class ComboBox : public ComboBoxBase
+    {
+    public:
+        using Provider = std::function<QStringList()>;
+
+    private:
+        QStringListModel* m_model = nullptr;
+        QCompleter* m_completer = nullptr;
+        Provider m_provider;
+        QPointer<QFutureWatcher<QStringList>> m_watcher;
+        int m_generation = 0;
+        bool m_loaded = false;
+        bool m_popupPending = false;
+
+    public:
+        explicit ComboBox(QWidget* parent = nullptr) : ComboBoxBase(parent) {
+            initUI();
+        }
+        ~ComboBox() override = default;
+
+        void initUI() {
+            m_model = new QStringListModel(this);
+            setModel(m_model);
+
+            QListView* popupView = new QListView(this);
+            popupView->setUniformItemSizes(true);
+            popupView->setLayoutMode(QListView::Batched);
+            popupView->setBatchSize(256);
+            setView(popupView);
+        }
+
+        /* Replace all items at once, a single model reset instead of one insert per item.
+        */
+        void setItems(const QStringList& items) {
+            const QString current = currentText();
+            m_model->setStringList(items);
+            if (!current.isEmpty()) {
+                const int index = findText(current);
+                if (index >= 0) setCurrentIndex(index);
+            }
+        }
+
+        QStringList items() const {
+            return m_model->stringList();
+        }
+
+        /* Items are requested from 'provider' on a worker thread the first time the popup opens
+        (and again after invalidate()). The popup opens as soon as they arrive.
+        */
+        void setLazyProvider(Provider provider) {
+            m_provider = std::move(provider);
+            invalidate();
+        }
+
+        void invalidate() {
+            m_loaded = false;
+            m_generation ++;
+        }
+
+        bool isLoading() const { return m_watcher && m_watcher->isRunning(); }
+
+        void requestItems() {
+            if (!m_provider || isLoading()) return;
+
+            const int generation = ++m_generation;
+            setPlaceholderText("Loading...");
+
+            auto* watcher = new QFutureWatcher<QStringList>(this);
+            m_watcher = watcher;
+            connect(watcher, &QFutureWatcher<QStringList>::finished, this, [this, watcher, generation]() {
+                watcher->deleteLater();
+                setPlaceholderText(QString());
+                // a newer request or invalidate() superseded this one, a popup still waiting needs fresh items
+                if (generation != m_generation) {
+                    if (m_popupPending) requestItems();
+                    return;
+                }
+
+                setItems(watcher->result());
+                m_loaded = true;
+                emit itemsLoaded();
+
+                if (m_popupPending) {
+                    m_popupPending = false;
+                    showPopup();
+                }
+            });
+            watcher->setFuture(QtConcurrent::run(m_provider));
+        }
+
+        /* Editable mode with a completer filtering the items while typing.
+        'mode' is Qt::MatchContains (substring) or Qt::MatchStartsWith (prefix).
+        */
+        void setFilterEnabled(const bool enabled, const Qt::MatchFlags mode = Qt::MatchContains) {
+            if (!enabled) {
+                setCompleter(nullptr);
+                delete m_completer;     // a child of the combo box, it would pile up across toggles
+                m_completer = nullptr;
+                setEditable(false);
+                return;
+            }
+
+            // already filtering, only the match mode may change
+            if (m_completer) {
+                m_completer->setFilterMode(mode);
+                return;
+            }
+
+            setEditable(true);
+            setInsertPolicy(QComboBox::NoInsert);
+
+            m_completer = new QCompleter(m_model, this);
+            m_completer->setCaseSensitivity(Qt::CaseInsensitive);
+            m_completer->setFilterMode(mode);
+            m_completer->setCompletionMode(QCompleter::PopupCompletion);
+            m_completer->setMaxVisibleItems(maxVisibleItems());
+            if (auto* completerView = qobject_cast<QListView*>(m_completer->popup())) {
+                completerView->setUniformItemSizes(true);
+                completerView->setLayoutMode(QListView::Batched);
+            }
+            setCompleter(m_completer);
+        }
+
+        void showPopup() override {
+            if (m_provider && !m_loaded) {
+                m_popupPending = true;
+                requestItems();
+                return;
+            }
+            ComboBoxBase::showPopup();
+        }
+    };
+
+
+    /* Compile-time description of the value held by a field widget,
+    used by OverrideFieldWidget<T>::value(), setValue(), onValueChanged() and bind().
+    Specialize it for your own widgets:
+
+        template <>
+        struct OverrideFieldTraits<MyWidget> {
+            using value_type = float;
+            static value_type get(const MyWidget* w) { return w->value(); }
+            static void set(MyWidget* w, const value_type& v) { w->setValue(v); }
+            static constexpr auto changed = &MyWidget::valueChanged;
+        };
+    */
+    template <typename T>
+    struct OverrideFieldTraits;
+
+    template <>
+    struct OverrideFieldTraits<QLineEdit> {
+        using value_type = QString;
+        static value_type get(const QLineEdit* w) { return w->text(); }
+        static void set(QLineEdit* w, const value_type& v) { w->setText(v); }
+        static constexpr auto changed = &QLineEdit::textChanged;
+    };
+
+    template <>
+    struct OverrideFieldTraits<QSpinBox> {
+        using value_type = int;
+        static value_type get(const QSpinBox* w) { return w->value(); }
+        static void set(QSpinBox* w, const value_type& v) { w->setValue(v); }
+        static constexpr auto changed = &QSpinBox::valueChanged;
+    };
+
+    template <>
+    struct OverrideFieldTraits<QDoubleSpinBox> {
+        using value_type = double;
+        static value_type get(const QDoubleSpinBox* w) { return w->value(); }
+        static void set(QDoubleSpinBox* w, const value_type& v) { w->setValue(v); }
+        static constexpr auto changed = &QDoubleSpinBox::valueChanged;
+    };
+
+    template <>
+    struct OverrideFieldTraits<QCheckBox> {
+        using value_type = bool;
+        static value_type get(const QCheckBox* w) { return w->isChecked(); }
+        static void set(QCheckBox* w, const value_type& v) { w->setChecked(v); }
+        static constexpr auto changed = &QCheckBox::toggled;
+    };
+
+    template <>
+    struct OverrideFieldTraits<QComboBox> {
+        using value_type = int;     // current index
+        static value_type get(const QComboBox* w) { return w->currentIndex(); }
+        static void set(QComboBox* w, const value_type& v) { w->setCurrentIndex(v); }
+        static constexpr auto changed = &QComboBox::currentIndexChanged;
+    };
+
+    template <>
+    struct OverrideFieldTraits<ComboBoxBase> : OverrideFieldTraits<QComboBox> {};
+
+    template <>
+    struct OverrideFieldTraits<ComboBox> : OverrideFieldTraits<QComboBox> {};
+
+    template <>
+    struct OverrideFieldTraits<QSlider> {
+        using value_type = int;
+        static value_type get(const QSlider* w) { return w->value(); }
+        static void set(QSlider* w, const value_type& v) { w->setValue(v); }
+        static constexpr auto changed = &QSlider::valueChanged;
+    };
 
 
     template <typename T>
@@ -220,6 +777,8 @@ namespace utilWidgets {
     private:
         QLabel* m_label = nullptr;
         T* m_field;
+        std::function<void()> m_pullBinding;
+        QMetaObject::Connection m_bindConnection;
 
     public:
         explicit OverrideFieldWidget(QWidget* parent = nullptr) : OverrideFieldWidgetBase(parent) {
@@ -275,7 +834,7 @@ namespace utilWidgets {
             m_label->setToolTip(override ? "Overrided" : "");
         }
 
-        QString getName() const {
+        QString getName() const override {
             return m_label->text();
         }
 
@@ -303,6 +862,75 @@ namespace utilWidgets {
         T* getField() { return m_field; }
         const T* getField() const { return m_field; }
 
+        /* Typed access through OverrideFieldTraits<T>, no QVariant or string round trip.
+        setValue() leaves the widget untouched (and silent) when the value is unchanged.
+        */
+        template <typename U = T>
+        typename OverrideFieldTraits<U>::value_type value() const {
+            return OverrideFieldTraits<U>::get(m_field);
+        }
+
+        template <typename U = T>
+        void setValue(const typename OverrideFieldTraits<U>::value_type& value) {
+            if (OverrideFieldTraits<U>::get(m_field) == value) return;
+            OverrideFieldTraits<U>::set(m_field, value);
+        }
+
+        /* Connect to the typed change signal of the field, e.g. void(int) for a QSpinBox.
+        */
+        template <typename Functor, typename U = T>
+        QMetaObject::Connection onValueChanged(const QObject* context, Functor&& functor) {
+            return connect(m_field, OverrideFieldTraits<U>::changed, context, std::forward<Functor>(functor));
+        }
+
+        /* Bind the field to a backing variable, typically a member of a settings struct.
+        Edits in the widget are written to it directly, and pull() pushes the variable
+        back into the widget. The variable must outlive the binding (see unbind()).
+
+        Example usage:
+            auto* samples = new utilWidgets::OverrideFieldWidget<QSpinBox>("Samples", this);
+            samples->bind(&m_renderSettings.samples);
+            ...
+            samples->pull();    // per tick, after the engine updated m_renderSettings
+        */
+        template <typename U = T>
+        void bind(typename OverrideFieldTraits<U>::value_type* variable) {
+            unbind();
+            if (variable == nullptr) return;
+
+            setValue<U>(*variable);
+            m_bindConnection = connect(m_field, OverrideFieldTraits<U>::changed, this, [this, variable]() {
+                *variable = OverrideFieldTraits<U>::get(m_field);
+            });
+            m_pullBinding = [this, variable]() {
+                setValue<U>(*variable);
+            };
+        }
+
+        void unbind() {
+            disconnect(m_bindConnection);
+            m_pullBinding = nullptr;
+        }
+
+        bool isBound() const { return static_cast<bool>(m_pullBinding); }
+
+        void pull() {
+            if (m_pullBinding) m_pullBinding();
+        }
+
+        /* Read/write the field through its USER property
+        (QLineEdit::text, QSpinBox::value, QCheckBox::checked, QComboBox::currentText, ...).
+        */
+        QVariant getFieldValue() const override {
+            QMetaProperty prop = m_field->metaObject()->userProperty();
+            return prop.isValid() ? prop.read(m_field) : QVariant();
+        }
+
+        bool setFieldValue(const QVariant& value) override {
+            QMetaProperty prop = m_field->metaObject()->userProperty();
+            return prop.isValid() && prop.write(m_field, value);
+        }
+
         void setFieldAlignment(Qt::Alignment alignment) {
             m_field->setAlignment(alignment);
         }
@@ -313,9 +941,12 @@ namespace utilWidgets {
     class MessageBox : public MessageBoxBase
     {
     private:
+        QLabel* m_msgLabel = nullptr;
         QHBoxLayout* m_btnLay = nullptr;
         QPushButton* m_clickedButton = nullptr;
         QStatusBar* m_statusbar = nullptr;
+        QList<QPushButton*> m_buttons;
+        std::function<void(MessageBox*)> m_recycler;
 
     public:
         explicit MessageBox(QWidget* parent = nullptr, const QString& title = "", const QString& msg = "")
@@ -330,6 +961,17 @@ namespace utilWidgets {
             emit(showRequested());
         }
 
+        void closeEvent(QCloseEvent* e) override {
+            MessageBoxBase::closeEvent(e);
+            emit(closed());
+            if (m_recycler) {
+                // hand the box back once the current signal handlers are done with it
+                QTimer::singleShot(0, this, [this]() {
+                    if (m_recycler && isHidden()) m_recycler(this);
+                });
+            }
+        }
+
         void initUI(const QString& title, const QString& msg) override {
             applyDarkMode(*this);
 
@@ -339,7 +981,7 @@ namespace utilWidgets {
             setWindowTitle(title.isEmpty() ? "No Titled" : title);
 
             // controls
-            QLabel* msgLb = new QLabel(msg);
+            m_msgLabel = new QLabel(msg);
             m_statusbar = new QStatusBar(this);
             m_statusbar->setHidden(true);
 
@@ -347,7 +989,7 @@ namespace utilWidgets {
             QVBoxLayout* lay = new QVBoxLayout(this);
             setLayout(lay);
 
-            lay->addWidget(msgLb);
+            lay->addWidget(m_msgLabel);
 
             m_btnLay = new QHBoxLayout(this);
             lay->addLayout(m_btnLay);
@@ -367,6 +1009,7 @@ namespace utilWidgets {
 
         void addButton(QPushButton* btn) {
             m_btnLay->addWidget(btn);
+            m_buttons.append(btn);
 
             connect(btn, &QPushButton::clicked, this, [this, btn]() {
                 m_clickedButton = btn;
@@ -375,6 +1018,48 @@ namespace utilWidgets {
             });
         }
 
+        /* Show one button per name, reusing the buttons already created and hiding the rest.
+        Returns the visible buttons in order.
+        */
+        QList<QPushButton*> setButtons(const QStringList& names) {
+            QList<QPushButton*> result;
+            for (int i = 0; i < names.count(); ++i) {
+                if (i >= m_buttons.count()) {
+                    addButton(new QPushButton(this));
+                }
+                QPushButton* btn = m_buttons.at(i);
+                btn->setText(names.at(i));
+                btn->setDefault(false);
+                btn->setHidden(false);
+                result.append(btn);
+            }
+            for (int i = names.count(); i < m_buttons.count(); ++i) {
+                m_buttons.at(i)->setHidden(true);
+            }
+            return result;
+        }
+
+        void setMessage(const QString& msg) {
+            m_msgLabel->setText(msg);
+        }
+
+        /* Reconfigure the box in place, used by MessageBoxPool.
+        */
+        void reset(const QString& title, const QString& msg) {
+            setWindowTitle(title.isEmpty() ? "No Titled" : title);
+            setMessage(msg);
+            m_clickedButton = nullptr;
+            m_statusbar->clearMessage();
+            m_statusbar->setHidden(true);
+        }
+
+        /* When set, closing the box hides it and passes it to 'recycler' instead of deleting it.
+        */
+        void setRecycler(std::function<void(MessageBox*)> recycler) {
+            m_recycler = std::move(recycler);
+            setAttribute(Qt::WA_DeleteOnClose, !m_recycler);
+        }
+
         void setStatusHidden(const bool hidden) {
             m_statusbar->setHidden(hidden);
         }
@@ -385,23 +1070,291 @@ namespace utilWidgets {
 
     };
 
-    inline void createDialog(const QString& title,
-                             const QString& msg,
-                             const QStringList& buttons,
-                             const QString& defaultBtn,
-                             MessageBox*& box,
-                             QPushButton*& defaultButton,
-                             QString& result,
-                             QEventLoop& loop,
-                             QWidget* parent = nullptr) {
-        // create dialog box
-        box = new MessageBox(parent, title, msg);
-        // create buttons
-        for (QString btnName : buttons) {
-            QPushButton* btn = new QPushButton(btnName, box);
-            box->addButton(btn);
+
+    /* Keeps a few prepared, hidden MessageBox instances and recycles them after use,
+    so showing a prompt costs a reconfigure and a show instead of building a new window.
+    dialog(), dialog_limited() and dialogAsync() take their boxes from MessageBoxPool::instance().
+
+    Example usage:
+        utilWidgets::MessageBoxPool::instance().prewarm(2);   // e.g. at startup
+    */
+    class MessageBoxPool
+    {
+    private:
+        QList<QPointer<MessageBox>> m_idle;
+        int m_maxIdle = 4;
+        bool m_enabled = true;
+        bool m_hooked = false;
+
+    public:
+        MessageBoxPool() = default;
+        ~MessageBoxPool() = default;     // boxes are deleted on QCoreApplication::aboutToQuit
+
+        MessageBoxPool(const MessageBoxPool&) = delete;
+        MessageBoxPool& operator=(const MessageBoxPool&) = delete;
+
+        static MessageBoxPool& instance() {
+            static MessageBoxPool pool;
+            return pool;
+        }
+
+        bool isEnabled() const { return m_enabled; }
+        void setEnabled(const bool enabled) {
+            m_enabled = enabled;
+            if (!enabled) clear();
+        }
+
+        int maxIdle() const { return m_maxIdle; }
+        void setMaxIdle(const int count) {
+            m_maxIdle = qMax(0, count);
+            while (m_idle.count() > m_maxIdle) {
+                delete m_idle.takeLast().data();
+            }
+        }
+
+        int idleCount() const { return m_idle.count(); }
+
+        void prewarm(const int count) {
+            if (!m_enabled) return;
+            while (m_idle.count() < qMin(count, m_maxIdle)) {
+                m_idle.append(createBox());
+            }
+        }
+
+        /* Returns a hidden box configured with 'title' and 'msg', parented to 'parent'.
+        Falls back to a plain self-deleting MessageBox when the pool is disabled.
+        */
+        MessageBox* acquire(QWidget* parent, const QString& title, const QString& msg) {
+            if (!m_enabled) {
+                return new MessageBox(parent, title, msg);
+            }
+
+            MessageBox* box = nullptr;
+            while (!box && !m_idle.isEmpty()) {
+                box = m_idle.takeLast().data();
+            }
+            if (!box) box = createBox();
+
+            box->setParent(parent, box->windowFlags());
+            box->reset(title, msg);
+            return box;
+        }
+
+        void release(MessageBox* box) {
+            if (box == nullptr) return;
+
+            // drop the connections made for the previous prompt
+            QObject::disconnect(box, &MessageBoxBase::buttonClicked, nullptr, nullptr);
+            QObject::disconnect(box, &MessageBoxBase::showRequested, nullptr, nullptr);
+            QObject::disconnect(box, &MessageBoxBase::closed, nullptr, nullptr);
+
+            if (!m_enabled || m_idle.count() >= m_maxIdle) {
+                box->deleteLater();
+                return;
+            }
+            box->setParent(nullptr, box->windowFlags());
+            m_idle.append(box);
+        }
+
+        void clear() {
+            for (const QPointer<MessageBox>& box : m_idle) {
+                delete box.data();
+            }
+            m_idle.clear();
+        }
+
+    private:
+        MessageBox* createBox() {
+            if (!m_hooked && QCoreApplication::instance()) {
+                m_hooked = true;
+                QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [this]() {
+                    clear();
+                });
+            }
+
+            MessageBox* box = new MessageBox();
+            box->setRecycler([this](MessageBox* b) { release(b); });
+            box->ensurePolished();
+            return box;
+        }
+    };
+
+    /* Decides whether dialog(), dialog_limited() and dialogAsync() show a prompt
+    or answer it right away, for batch and test runs where nobody is watching.
+
+    Modes:
+        Interactive  answer with a matching scripted rule, otherwise show the prompt (default)
+        AutoDefault  answer with a matching scripted rule, otherwise with the default button
+        FailFast     answer with a matching scripted rule, otherwise log an error and answer
+                     with an empty string, like a box closed by its window button
+
+    Environment variables, read on first use:
+        UTILWIDGETS_DIALOG_POLICY   interactive | auto | fail
+        UTILWIDGETS_DIALOG_ANSWERS  <title regex>=<answer>;<title regex>=<answer>
+    Without UTILWIDGETS_DIALOG_POLICY, the offscreen and minimal Qt platforms default to AutoDefault.
+    Answers have to name one of the prompt's buttons (case-insensitively), others are ignored.
+    Every automatic answer is logged.
+
+    Example usage:
+        utilWidgets::DialogPolicy& policy = utilWidgets::DialogPolicy::instance();
+        policy.setMode(utilWidgets::DialogPolicy::AutoDefault);
+        policy.addRule("^Overwrite", "Yes");
+    */
+    class DialogPolicy
+    {
+    public:
+        enum Mode {
+            Interactive = 0,
+            AutoDefault,
+            FailFast
+        };
+
+        using Handler = std::function<std::optional<QString>(const QString& title,
+                                                             const QString& msg,
+                                                             const QStringList& buttons,
+                                                             const QString& defaultBtn)>;
+
+    private:
+        struct Rule {
+            QRegularExpression titlePattern;
+            QString answer;
+        };
+
+        Mode m_mode = Interactive;
+        QList<Rule> m_rules;
+        Handler m_handler;
+
+        DialogPolicy() {
+            configureFromEnvironment();
+        }
+
+    public:
+        static DialogPolicy& instance() {
+            static DialogPolicy policy;
+            return policy;
+        }
+
+        Mode mode() const { return m_mode; }
+        void setMode(const Mode mode) { m_mode = mode; }
+
+        // false for an invalid pattern, which is reported and not added
+        bool addRule(const QString& titlePattern, const QString& answer) {
+            const QRegularExpression regex(titlePattern);
+            if (!regex.isValid()) {
+                qWarning().noquote() << QString("utilWidgets: invalid dialog rule pattern '%1': %2")
+                                        .arg(titlePattern, regex.errorString());
+                return false;
+            }
+            m_rules.append({regex, answer});
+            return true;
+        }
+        void clearRules() { m_rules.clear(); }
+
+        /* Custom decision hook, consulted before the mode and the rules.
+        Return std::nullopt to fall through.
+        */
+        void setHandler(Handler handler) { m_handler = std::move(handler); }
+
+        void configureFromEnvironment() {
+            const QString mode = qEnvironmentVariable("UTILWIDGETS_DIALOG_POLICY").trimmed().toLower();
+            if (mode == "auto" || mode == "autodefault") {
+                m_mode = AutoDefault;
+            } else if (mode == "fail" || mode == "failfast") {
+                m_mode = FailFast;
+            } else if (mode == "interactive") {
+                m_mode = Interactive;
+            } else if (mode.isEmpty()) {
+                const QString platform = QGuiApplication::platformName();
+                if (platform == "offscreen" || platform == "minimal")
+                    m_mode = AutoDefault;
+            } else {
+                qWarning() << "Unknown UTILWIDGETS_DIALOG_POLICY value:" << mode;
+            }
+
+            const QString answers = qEnvironmentVariable("UTILWIDGETS_DIALOG_ANSWERS");
+            for (const QString& pair : answers.split(';', Qt::SkipEmptyParts)) {
+                const int sep = pair.lastIndexOf('=');
+                if (sep <= 0) {
+                    qWarning() << "Malformed UTILWIDGETS_DIALOG_ANSWERS entry:" << pair;
+                    continue;
+                }
+                addRule(pair.left(sep), pair.mid(sep + 1));
+            }
+        }
+
+        /* The automatic answer for this prompt, or std::nullopt to show it.
+        */
+        std::optional<QString> answer(const QString& title,
+                                      const QString& msg,
+                                      const QStringList& buttons,
+                                      const QString& defaultBtn) const {
+            if (m_handler) {
+                if (std::optional<QString> result = m_handler(title, msg, buttons, defaultBtn)) {
+                    if (std::optional<QString> button = matchButton(title, *result, buttons, "handler")) {
+                        log(title, *button, "handler");
+                        return button;
+                    }
+                }
+            }
+
+            for (const Rule& rule : m_rules) {
+                if (!rule.titlePattern.match(title).hasMatch()) continue;
+                const QString reason = "rule " + rule.titlePattern.pattern();
+                if (std::optional<QString> button = matchButton(title, rule.answer, buttons, reason)) {
+                    log(title, *button, reason);
+                    return button;
+                }
+            }
+            if (m_mode == Interactive) return std::nullopt;
+
+            if (m_mode == FailFast) {
+                qCritical().noquote() << QString("utilWidgets: dialog '%1' (%2) needs an answer but the dialog policy is fail-fast, "
+                                                 "answering as closed").arg(title, msg);
+                return QString();
+            }
+            if (buttons.contains(defaultBtn)) {
+                log(title, defaultBtn, "default");
+                return defaultBtn;
+            }
+            // no usable default button, fall back to the first one
+            const QString first = buttons.value(0);
+            log(title, first, "first button");
+            return first;
+        }
+
+    private:
+        // the button 'answer' names, std::nullopt (reported) when there is none
+        static std::optional<QString> matchButton(const QString& title, const QString& answer,
+                                                  const QStringList& buttons, const QString& reason) {
+            for (const QString& button : buttons) {
+                if (button.compare(answer, Qt::CaseInsensitive) == 0) return button;
+            }
+            qWarning().noquote() << QString("utilWidgets: ignoring answer '%1' (%2) for dialog '%3', its buttons are %4")
+                                    .arg(answer, reason, title, buttons.join(", "));
+            return std::nullopt;
+        }
+
+        static void log(const QString& title, const QString& answer, const QString& reason) {
+            qInfo().noquote() << QString("utilWidgets: auto-answered dialog '%1' with '%2' (%3)")
+                                 .arg(title, answer, reason);
+        }
+    };
+
+    /* Create a MessageBox with its buttons, centered on its parent when shown.
+    Shared by dialog(), dialog_limited() and dialogAsync().
+    */
+    inline MessageBox* buildDialog(const QString& title,
+                                   const QString& msg,
+                                   const QStringList& buttons,
+                                   const QString& defaultBtn,
+                                   QPushButton*& defaultButton,
+                                   QWidget* parent = nullptr) {
+        // get a dialog box, recycled when possible
+        MessageBox* box = MessageBoxPool::instance().acquire(parent, title, msg);
+        // set buttons
+        for (QPushButton* btn : box->setButtons(buttons)) {
             // set default button
-            if (btnName == defaultBtn) {
+            if (btn->text() == defaultBtn) {
                 defaultButton = btn;
             }
         }
@@ -411,12 +1364,8 @@ namespace utilWidgets {
             defaultButton->setFocusPolicy(Qt::StrongFocus);
         }
 
-        QObject::connect(box, &MessageBox::buttonClicked, &loop, [&](QPushButton* btn) {
-            result = btn->text();
-            loop.quit();
-        });
-
-        QObject::connect(box, &MessageBox::showRequested, box, [&box, &defaultButton]() {
+        QPushButton* focusButton = defaultButton;
+        QObject::connect(box, &MessageBox::showRequested, box, [box, focusButton]() {
             box->show();
             box->adjustSize();
             QWidget* parentWidget = box->parentWidget();
@@ -430,13 +1379,33 @@ namespace utilWidgets {
                 box->raise();
                 box->setFocus();
             });
-            if (defaultButton) {
-                QTimer::singleShot(0, defaultButton, [defaultButton]() {
-                    defaultButton->setFocus();
+            if (focusButton) {
+                QTimer::singleShot(0, focusButton, [focusButton]() {
+                    focusButton->setFocus();
                 });
             }
         });
 
+        return box;
+    }
+
+    inline void createDialog(const QString& title,
+                             const QString& msg,
+                             const QStringList& buttons,
+                             const QString& defaultBtn,
+                             MessageBox*& box,
+                             QPushButton*& defaultButton,
+                             QString& result,
+                             QEventLoop& loop,
+                             QWidget* parent = nullptr) {
+        box = buildDialog(title, msg, buttons, defaultBtn, defaultButton, parent);
+
+        QObject::connect(box, &MessageBox::buttonClicked, &loop, [&](QPushButton* btn) {
+            result = btn->text();
+            loop.quit();
+        });
+        // closed by the window button
+        QObject::connect(box, &MessageBox::closed, &loop, &QEventLoop::quit);
     }
 
     inline QString dialog(QWidget* parent = nullptr,
@@ -444,6 +1413,9 @@ namespace utilWidgets {
                           const QString& msg = "",
                           const QStringList& buttons = {"Ok"},
                           const QString& defaultBtn = "Ok") {
+        if (std::optional<QString> answer = DialogPolicy::instance().answer(title, msg, buttons, defaultBtn))
+            return *answer;
+
         QEventLoop loop;
         QString result;
         MessageBox* box = nullptr;
@@ -463,6 +1435,9 @@ namespace utilWidgets {
                                   const QStringList& buttons = {"Ok"},
                                   const QString& defaultBtn = "Ok",
                                   const int timeOut = -1) {
+        if (std::optional<QString> answer = DialogPolicy::instance().answer(title, msg, buttons, defaultBtn))
+            return *answer;
+
         QEventLoop loop;
         QString result;
         MessageBox* box = nullptr;
@@ -476,7 +1451,7 @@ namespace utilWidgets {
         int* remainingPtr = &remaining;
         box->setStatusMessage(statusMsgHead + QString("Closing in %1").arg(remaining));
 
-        QTimer* timer = new QTimer(box);
+        QPointer<QTimer> timer = new QTimer(box);
         QObject::connect(timer, &QTimer::timeout, [&loop, &result, box, &statusMsgHead, &defaultBtn, remainingPtr]() {
             (*remainingPtr) --;
             if ((*remainingPtr) <= 0) {
@@ -490,55 +1465,335 @@ namespace utilWidgets {
 
         timer->start(1000);
         loop.exec();
+        // the box may be recycled, do not leave the countdown behind
+        delete timer.data();
 
         return result;
     }
 
+    /* Non-blocking variant of dialog(), no nested event loop is spun.
+    The returned future finishes with the clicked button text, with defaultBtn when
+    'timeOut' (ms, -1 waits forever) expires, or with an empty string when the box is closed.
+    Canceling the future closes the box.
 
-    class LogView : public QWidget
+    Example usage:
+        QFuture<QString> answer = utilWidgets::dialogAsync(this, "Confirm", "Apply this value?", {"Yes", "No"}, "No", 10000);
+        answer.then(this, [](const QString& result) { ... });
+        ...
+        answer.cancel();    // closes the box if it is still open
+    */
+    inline QFuture<QString> dialogAsync(QWidget* parent = nullptr,
+                                        const QString& title = "",
+                                        const QString& msg = "",
+                                        const QStringList& buttons = {"Ok"},
+                                        const QString& defaultBtn = "Ok",
+                                        const int timeOut = -1) {
+        auto promise = std::make_shared<QPromise<QString>>();
+        QFuture<QString> future = promise->future();
+        promise->start();
+
+        if (std::optional<QString> answer = DialogPolicy::instance().answer(title, msg, buttons, defaultBtn)) {
+            promise->addResult(*answer);
+            promise->finish();
+            return future;
+        }
+
+        auto done = std::make_shared<bool>(false);
+        auto finish = [promise, done](const QString& result) {
+            if (*done) return;
+            *done = true;
+            if (!promise->isCanceled())
+                promise->addResult(result);
+            promise->finish();
+        };
+
+        QPushButton* defaultButton = nullptr;
+        MessageBox* box = buildDialog(title, msg, buttons, defaultBtn, defaultButton, parent);
+
+        // owns everything attached to this prompt, so a recycled box starts clean
+        QObject* session = new QObject(box);
+        auto finishSession = [finish, session](const QString& result) {
+            finish(result);
+            session->deleteLater();
+        };
+
+        QObject::connect(box, &MessageBox::buttonClicked, session, [finishSession](QPushButton* btn) {
+            finishSession(btn->text());
+        });
+        // closed by the window button
+        QObject::connect(box, &MessageBox::closed, session, [finishSession]() {
+            finishSession(QString());
+        });
+        // deleted with its parent (QWidget emits destroyed() before deleting its children)
+        QObject::connect(box, &QObject::destroyed, session, [finish]() {
+            finish(QString());
+        });
+
+        auto* watcher = new QFutureWatcher<QString>(session);
+        QObject::connect(watcher, &QFutureWatcher<QString>::canceled, box, &QWidget::close);
+        watcher->setFuture(future);
+
+        if (timeOut > 0) {
+            QString statusMsgHead = QString("Default Selection : [ %1 ] - ").arg(defaultBtn);
+            auto remaining = std::make_shared<int>(timeOut / 1000);
+            box->setStatusMessage(statusMsgHead + QString("Closing in %1").arg(*remaining));
+
+            QTimer* timer = new QTimer(session);
+            QObject::connect(timer, &QTimer::timeout, session, [box, finishSession, statusMsgHead, defaultBtn, remaining]() {
+                (*remaining) --;
+                if ((*remaining) <= 0) {
+                    finishSession(defaultBtn);
+                    box->close();
+                } else {
+                    box->setStatusMessage(statusMsgHead + QString("Closing in %1").arg(*remaining));
+                }
+            });
+            timer->start(1000);
+        }
+
+        box->show();
+        return future;
+    }
+
+    /* Callback flavour of dialogAsync(). 'onFinished' runs on the GUI thread
+    with the same result the future would carry (empty when canceled).
+    */
+    inline void dialogAsync(QWidget* parent,
+                            const QString& title,
+                            const QString& msg,
+                            const QStringList& buttons,
+                            const QString& defaultBtn,
+                            const int timeOut,
+                            std::function<void(const QString&)> onFinished) {
+        QFuture<QString> future = dialogAsync(parent, title, msg, buttons, defaultBtn, timeOut);
+
+        auto* watcher = new QFutureWatcher<QString>();
+        QObject::connect(watcher, &QFutureWatcher<QString>::finished, watcher, [watcher, onFinished]() {
+            QFuture<QString> f = watcher->future();
+            if (onFinished)
+                onFinished(f.resultCount() > 0 ? f.result() : QString());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(future);
+    }
+
+
+    /* Progress shared between worker threads and a ProgressDialog.
+    Workers only touch atomics (a relaxed store or add per report), the dialog samples
+    them on its own refresh timer, so reporting from tight loops never queues signals.
+
+    Example usage:
+        auto channel = std::make_shared<utilWidgets::ProgressChannel>();
+        channel->setTotal(items.size());
+        new utilWidgets::ProgressDialog(this, "Export", "Exporting items...", channel);
+
+        QtConcurrent::run([channel, items]() {
+            for (qint64 i = 0; i < items.size(); ++i) {
+                if (channel->isCanceled()) break;
+                ...
+                channel->setProgress(i + 1);
+            }
+            channel->finish();
+        });
+    */
+    class ProgressChannel
     {
     private:
-        QTextEdit* m_logField = nullptr;
+        std::atomic<qint64> m_done{0};
+        std::atomic<qint64> m_total{0};
+        std::atomic<bool> m_canceled{false};
+        std::atomic<bool> m_finished{false};
+
+        // phase text, meant for occasional updates only
+        mutable QMutex m_textMutex;
+        QString m_text;
+        std::atomic<bool> m_textDirty{false};
 
     public:
-        explicit LogView(QWidget* parent = nullptr) : QWidget(parent) {
-            initUI();
+        ProgressChannel() = default;
+        explicit ProgressChannel(const qint64 total) : m_total(total) {}
+
+        void setTotal(const qint64 total) { m_total.store(total, std::memory_order_relaxed); }
+        qint64 total() const { return m_total.load(std::memory_order_relaxed); }
+
+        void setProgress(const qint64 done) { m_done.store(done, std::memory_order_relaxed); }
+        void advance(const qint64 delta = 1) { m_done.fetch_add(delta, std::memory_order_relaxed); }
+        qint64 progress() const { return m_done.load(std::memory_order_relaxed); }
+
+        void cancel() { m_canceled.store(true, std::memory_order_relaxed); }
+        bool isCanceled() const { return m_canceled.load(std::memory_order_relaxed); }
+
+        void finish() { m_finished.store(true, std::memory_order_release); }
+        bool isFinished() const { return m_finished.load(std::memory_order_acquire); }
+
+        void setText(const QString& text) {
+            QMutexLocker locker(&m_textMutex);
+            m_text = text;
+            m_textDirty.store(true, std::memory_order_release);
         }
-        ~LogView() = default;
 
-        void initUI() {
-            // controls
-            QPushButton* clearBtn = new QPushButton(this);
-            clearBtn->setIcon(this->style()->standardPixmap(QStyle::SP_TrashIcon));
-            clearBtn->setFixedSize(QSize(20,20));
-            clearBtn->setToolTip("Clear Log Field");
+        // GUI side: returns true and the new text when it changed since the last call
+        bool takeText(QString& text) {
+            if (!m_textDirty.load(std::memory_order_acquire)) return false;
+            QMutexLocker locker(&m_textMutex);
+            text = m_text;
+            m_textDirty.store(false, std::memory_order_relaxed);
+            return true;
+        }
+    };
 
-            m_logField = new QTextEdit(this);
-            m_logField->setLineWrapMode(QTextEdit::NoWrap);
-            m_logField->setReadOnly(true);
+
+    /* Progress window sampling a ProgressChannel at a fixed refresh rate,
+    with throughput, ETA and cooperative cancellation (the Cancel button and
+    the window close button only set ProgressChannel::cancel()).
+    Completion is ProgressChannel::finish() or the total being reached, whichever comes first.
+    Closes itself once the channel is finished or the total is reached.
+    */
+    class ProgressDialog : public MessageBoxBase
+    {
+    private:
+        std::shared_ptr<ProgressChannel> m_channel;
+        QLabel* m_msgLabel = nullptr;
+        QLabel* m_statsLabel = nullptr;
+        QProgressBar* m_progressBar = nullptr;
+        QPushButton* m_cancelBtn = nullptr;
+        QTimer* m_refreshTimer = nullptr;
+
+        QElapsedTimer m_elapsed;
+        qint64 m_lastDone = 0;
+        qint64 m_lastMs = 0;
+        double m_rate = 0.0;     // items per second, smoothed
+        bool m_autoClose = true;
+        bool m_completed = false;   // finished or the total reached, closing is not a cancel then
+
+    public:
+        explicit ProgressDialog(QWidget* parent,
+                                const QString& title,
+                                const QString& msg,
+                                std::shared_ptr<ProgressChannel> channel,
+                                const int refreshMs = 100)
+            : MessageBoxBase(parent), m_channel(std::move(channel)) {
+            initUI(title, msg);
+
+            m_elapsed.start();
+            m_refreshTimer->start(qMax(15, refreshMs));
+            show();
+        }
+        ~ProgressDialog() override = default;
+
+        std::shared_ptr<ProgressChannel> channel() const { return m_channel; }
+
+        void setAutoClose(const bool autoClose) { m_autoClose = autoClose; }
+
+    protected:
+        void initUI(const QString& title, const QString& msg) override {
+            applyDarkMode(*this);
+
+            setAttribute(Qt::WA_DeleteOnClose);
+            setWindowFlags(Qt::Window|Qt::WindowCloseButtonHint);
+            setWindowTitle(title.isEmpty() ? "Progress" : title);
+            setMinimumWidth(360);
+
+            // controls
+            m_msgLabel = new QLabel(msg, this);
+            m_progressBar = new QProgressBar(this);
+            m_progressBar->setRange(0, 1000);
+            m_progressBar->setTextVisible(true);
+            m_statsLabel = new QLabel(this);
+            m_cancelBtn = new QPushButton("Cancel", this);
+            m_refreshTimer = new QTimer(this);
 
             // layouts
             QVBoxLayout* lay = new QVBoxLayout(this);
-            lay->setSpacing(2);
-            lay->setContentsMargins(1,1,1,1);
             setLayout(lay);
 
-            QHBoxLayout* topLay = new QHBoxLayout(this);
-            lay->addLayout(topLay);
+            lay->addWidget(m_msgLabel);
+            lay->addWidget(m_progressBar);
+            lay->addWidget(m_statsLabel);
 
-            topLay->addWidget(new QLabel(" Log ", this));
-            topLay->addWidget(clearBtn);
+            QHBoxLayout* btnLay = new QHBoxLayout();
+            btnLay->addStretch();
+            btnLay->addWidget(m_cancelBtn);
+            lay->addLayout(btnLay);
 
-            lay->addWidget(m_logField);
+            // signals
+            connect(m_refreshTimer, &QTimer::timeout, this, [this]() { sample(); });
+            connect(m_cancelBtn, &QPushButton::clicked, this, [this]() {
+                requestCancel();
+                emit(buttonClicked(m_cancelBtn));
+            });
+        }
 
-            // connections
-            connect(clearBtn, &QPushButton::clicked, m_logField, &QTextEdit::clear);
+        void closeEvent(QCloseEvent* e) override {
+            // only the user closing the window cancels, not autoClose or a close() by the owner
+            if (e->spontaneous() && !m_completed && m_channel && !m_channel->isFinished())
+                requestCancel();
+            m_refreshTimer->stop();
+            MessageBoxBase::closeEvent(e);
+            emit(closed());
         }
 
-        QTextEdit* getField() const {
-            return m_logField;
+    private:
+        void requestCancel() {
+            if (m_channel) m_channel->cancel();
+            m_cancelBtn->setEnabled(false);
+            m_cancelBtn->setText("Canceling...");
         }
 
+        void sample() {
+            if (!m_channel) return;
+
+            QString text;
+            if (m_channel->takeText(text))
+                m_msgLabel->setText(text);
+
+            const qint64 done = m_channel->progress();
+            const qint64 total = m_channel->total();
+            const qint64 nowMs = m_elapsed.elapsed();
+
+            // throughput, exponentially smoothed over the refresh ticks
+            const qint64 dt = nowMs - m_lastMs;
+            if (dt > 0) {
+                const double instant = double(done - m_lastDone) * 1000.0 / double(dt);
+                m_rate = m_lastMs == 0 ? instant : (0.3 * instant + 0.7 * m_rate);
+                m_lastDone = done;
+                m_lastMs = nowMs;
+            }
+
+            if (total > 0) {
+                m_progressBar->setRange(0, 1000);
+                m_progressBar->setValue(static_cast<int>(qBound<qint64>(0, done * 1000 / total, 1000)));
+            } else {
+                m_progressBar->setRange(0, 0);  // busy indicator
+            }
+
+            QLocale locale;
+            QString stats = total > 0
+                ? QString("%1 / %2").arg(locale.toString(done), locale.toString(total))
+                : locale.toString(done);
+            stats += QString("  |  %1/s").arg(locale.toString(m_rate, 'f', m_rate < 10.0 ? 1 : 0));
+            stats += QString("  |  Elapsed %1").arg(formatDuration(nowMs / 1000));
+            if (total > 0 && m_rate > 0.0 && done < total) {
+                stats += QString("  |  ETA %1").arg(formatDuration(qint64((total - done) / m_rate)));
+            }
+            m_statsLabel->setText(stats);
+
+            const bool finished = m_channel->isFinished() || (total > 0 && done >= total);
+            if (finished) {
+                m_completed = true;
+                m_refreshTimer->stop();
+                if (m_autoClose) close();
+            }
+        }
+
+        static QString formatDuration(qint64 seconds) {
+            const qint64 h = seconds / 3600;
+            const qint64 m = (seconds % 3600) / 60;
+            const qint64 sec = seconds % 60;
+            if (h > 0)
+                return QString("%1:%2:%3").arg(h).arg(m, 2, 10, QChar('0')).arg(sec, 2, 10, QChar('0'));
+            return QString("%1:%2").arg(m, 2, 10, QChar('0')).arg(sec, 2, 10, QChar('0'));
+        }
     };
 
 }   // namespace utilWidgets
@@ -563,19 +1818,30 @@ namespace debug_util {
         QString msg = "";
         QTextStream msgStream(&msg, QIODevice::WriteOnly);
 
-        QProcessEnvironment currentEnv = QProcessEnvironment::systemEnvironment();
-        for (const QString& key : currentEnv.keys()) {
-            QString value = qEnvironmentVariable(key.toUtf8().constData(), "");
-            if (!value.isEmpty() && key == envName) {
-                msgStream << key << " : " << value;
-            }
-        }
-        if (msg.isEmpty()) {
+        const QString value = qEnvironmentVariable(envName.toUtf8().constData());
+        if (!value.isEmpty()) {
+            msgStream << envName << " : " << value;
+        } else {
             msgStream << "Environment variable '" << envName << "' is not set.";
         }
         utilWidgets::dialog(parent, "Environment", msg);
     }
 
+    /* show a whole environment in a filterable table, the app's own environment by default.
+
+    Example usage:
+        debug_util::showEnvironmentView(process->processEnvironment(), this);
+    */
+    inline void showEnvironmentView(const QProcessEnvironment& env = general_util::baseEnvironment(),
+                                    QWidget* parent = nullptr) {
+        utilWidgets::EnvironmentView* view = new utilWidgets::EnvironmentView(parent);
+        view->setWindowFlag(Qt::Window);
+        view->setWindowTitle("Environment");
+        view->setAttribute(Qt::WA_DeleteOnClose);
+        view->setEnvironment(env);
+        view->show();
+    }
+
 
 }   // namespace debug_util
 
@@ -583,20 +1849,14 @@ namespace debug_util {
 namespace general_util {
 
     /* Function to read an ASCII file and return its content as a QString.
-    This function opens the specified file in read-only mode, reads its content,
-    and returns it as a QString.
+    The file is read, not mapped: a mapping of a file truncated by another process faults
+    on access, use MappedFile where zero-copy access is worth that.
+    On failure an empty string is returned and 'error' (when given) holds the reason.
     */
-    inline QString readAsciiFile(const QString& path) {
-        QString code = "";
-
-        QFile scriptFile(path);
-        if (scriptFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&scriptFile);
-            code = in.readAll();
-            scriptFile.close();
-        }
-
-        return code;
+    inline QString readAsciiFile(const QString& path, QString* error = nullptr) {
+        const FileReadResult result = readFile(path);
+        if (error) *error = result.error;
+        return result.text();
     }
 
     inline QString userDocPath() {
@@ -660,23 +1920,15 @@ namespace general_util {
     inline QStringList getPythonFilePaths(const QString& rootPath,
                                           const bool recursive = false,
                                           const bool skipInit = true) {
-        QStringList result;
-
-        QDirIterator::IteratorFlags flags = recursive
-                                            ? QDirIterator::Subdirectories
-                                            : QDirIterator::NoIteratorFlags;
-        QDirIterator it(rootPath, QStringList() << "*.py", QDir::Files, flags);
-        while (it.hasNext()) {
-            QString filePath = it.next();
-            QString fileName = QFileInfo(filePath).fileName();
-            // Skip __init__.py files
-            if (skipInit && fileName == "__init__.py") {
-                continue;
-            }
-            result << filePath;
-        }
-
-        return result;
+        // subdirectories are walked in parallel, __pycache__ is never entered.
+        // Like QDirIterator with QDir::Files: hidden entries (.venv, .tox) are skipped, "*.py" matches "*.PY" too
+        DirectoryScanOptions options;
+        options.nameFilters = {"*.py"};
+        options.recursive = recursive;
+        options.hidden = false;
+        options.caseSensitivity = Qt::CaseInsensitive;
+        if (skipInit) options.excludeFiles = {"__init__.py"};
+        return findFiles({rootPath}, options);
     }
 
     /* Function to get file base name only from given file path.
@@ -689,7 +1941,7 @@ namespace general_util {
     */
     inline QProcess* getWorkProcess(QWidget* parent = nullptr) {
         QProcess* proc = new QProcess(parent);
-        proc->setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+        proc->setProcessEnvironment(baseEnvironment());
         proc->setProcessChannelMode(QProcess::MergedChannels);
         QObject::connect(proc, &QProcess::finished, proc, &QObject::deleteLater);
 
@@ -697,26 +1949,20 @@ namespace general_util {
     }
     /* Get a QProcess object with the current environment variables and PYTHONPATH set to the given paths.
     This function is useful for running Python scripts with specific PYTHONPATH settings.
+    Entries use the platform separator and are deduplicated, the environment is shared between
+    processes launched with the same paths (see pythonEnvironment()).
     */
     inline QProcess* getWorkProcess(const QStringList& pyPaths, QWidget* parent = nullptr) {
         QProcess* proc = new QProcess(parent);
 
         // expand the PYTHONPATH environment variable with the given paths
-        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-        QString fullPath = env.value("PYTHONPATH");
-        for (const QString& pyPath : pyPaths) {
-            if (!fullPath.isEmpty())
-                fullPath += ";";
-            fullPath += pyPath;
-        }
-        env.insert("PYTHONPATH", fullPath);
-
-        proc->setProcessEnvironment(env);
+        proc->setProcessEnvironment(pythonEnvironment(pyPaths));
         proc->setProcessChannelMode(QProcess::MergedChannels);
 
         return proc;
     }
 
+#ifdef _WIN32
     inline bool isRunningPID(const qint64 pid) {
         HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, static_cast<DWORD>(pid));
         if (!hProcess) return false;
@@ -750,6 +1996,31 @@ namespace general_util {
         CloseHandle(hProcess);
         return result;
     }
+#else
+    inline bool isRunningPID(const qint64 pid) {
+        if (pid <= 0) return false;
+        if (::kill(static_cast<pid_t>(pid), 0) != 0 && errno != EPERM) return false;
+
+        // a zombie has exited already, it only waits for its parent to reap it
+        QFile stat(QString("/proc/%1/stat").arg(pid));
+        if (stat.open(QIODevice::ReadOnly)) {
+            const QByteArray line = stat.readLine();
+            const int end = line.lastIndexOf(')');
+            if (end >= 0 && end + 2 < line.size() && line.at(end + 2) == 'Z') return false;
+        }
+        return true;
+    }
+
+    inline bool killPID(const qint64 pid) {
+        if (pid <= 0) return false;
+        if (::kill(static_cast<pid_t>(pid), SIGKILL) != 0) {
+            qWarning() << "Failed to terminate process. PID:" << pid
+                    << "Error code:" << errno;
+            return false;
+        }
+        return true;
+    }
+#endif
 
     inline QString quote(const QString& string) {
         if (string.isEmpty()) return "\"\"";
@@ -761,6 +2032,7 @@ namespace general_util {
         return result;
     }
 
+#ifdef _WIN32
     inline void openInExplorer(const std::wstring& absPath) {
         std::wstring param = L"\"" + absPath + L"\"";
         ShellExecuteW(nullptr, L"open", L"explorer.exe", param.c_str(), nullptr, SW_SHOWDEFAULT);
@@ -770,6 +2042,16 @@ namespace general_util {
         std::wstring param = L"/select,\"" + absPath + L"\"";
         ShellExecuteW(nullptr, L"open", L"explorer.exe", param.c_str(), nullptr, SW_SHOWDEFAULT);
     }
+#else
+    // outside Windows the desktop's default handler is used, selecting a file opens its folder
+    inline void openInExplorer(const std::wstring& absPath) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(QString::fromStdWString(absPath)));
+    }
+
+    inline void selectInExplorer(const std::wstring& absPath) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(QString::fromStdWString(absPath)).absolutePath()));
+    }
+#endif
 
 }   // namespace general_util
 
@@ -5,7 +5,20 @@ INCLUDEPATH += $$PWD/include
 HEADERS += \
     $$PWD/include/utils.h \
     $$PWD/include/utilWidgetsBases.h \
-    $$PWD/include/CustomTreeWidget.h
+    $$PWD/include/LogView.h \
+    $$PWD/include/EnvironmentBuilder.h \
+    $$PWD/include/CustomTreeWidget.h \
+    $$PWD/include/PropertyGrid.h \
+    $$PWD/include/OverrideGroup.h \
+    $$PWD/include/NotificationCenter.h \
+    $$PWD/include/ProcessScheduler.h \
+    $$PWD/include/PythonWorkerPool.h \
+    $$PWD/include/ProcessMonitor.h \
+    $$PWD/include/ProcessTelemetry.h \
+    $$PWD/include/ScriptResultCache.h \
+    $$PWD/include/DirectoryScanner.h \
+    $$PWD/include/ScriptCatalog.h \
+    $$PWD/include/FileReader.h
 
 # Qt modules required
-QT += widgets core gui
+QT += widgets core gui concurrent